@@ -0,0 +1,53 @@
+#include "coro/coro.hpp"
+
+using namespace coro;
+
+// one multishot sqe receives all data of the connection, buffers are borrowed from provided buffer ring
+task<> session(int fd)
+{
+    auto conn = io::net::tcp::tcp_connector(fd);
+    int  ret  = 0;
+
+    {
+        auto stream = conn.recv_multishot();
+        while (true)
+        {
+            auto buf = co_await stream.next();
+            if ((ret = buf.result()) <= 0)
+            {
+                break;
+            }
+            ret = co_await conn.write(buf.data(), buf.size());
+            if (ret <= 0)
+            {
+                break;
+            }
+        }
+    }
+
+    ret = co_await conn.close();
+    assert(ret == 0);
+}
+
+// one multishot sqe accepts all connections, server doesn't rearm accept for each connection
+task<> server(int port)
+{
+    auto server = io::net::tcp::tcp_server(port);
+    auto stream = server.accept_multishot();
+    log::info("server start in {}", port);
+    int client_fd;
+    while ((client_fd = co_await stream.next()) > 0)
+    {
+        submit_to_scheduler(session(client_fd));
+    }
+}
+
+int main(int argc, char const* argv[])
+{
+    /* code */
+    scheduler::init();
+
+    submit_to_scheduler(server(8000));
+    scheduler::loop();
+    return 0;
+}
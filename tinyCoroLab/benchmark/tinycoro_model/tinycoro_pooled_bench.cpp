@@ -0,0 +1,49 @@
+#include "coro/coro.hpp"
+
+using namespace coro;
+
+// session doesn't own read buffer, the buffer is borrowed from engine's provided buffer ring
+// only when data arrives, so memory cost is proportional to in-flight data
+task<> session(int fd)
+{
+    auto conn = io::net::tcp::tcp_connector(fd);
+    int  ret  = 0;
+
+    while (true)
+    {
+        auto buf = co_await conn.recv_pooled();
+        if ((ret = buf.result()) <= 0)
+        {
+            break;
+        }
+        ret = co_await conn.write(buf.data(), buf.size());
+        if (ret <= 0)
+        {
+            break;
+        }
+    }
+
+    ret = co_await conn.close();
+    assert(ret == 0);
+}
+
+task<> server(int port)
+{
+    auto server = io::net::tcp::tcp_server(port);
+    log::info("server start in {}", port);
+    int client_fd;
+    while ((client_fd = co_await server.accept()) > 0)
+    {
+        submit_to_scheduler(session(client_fd));
+    }
+}
+
+int main(int argc, char const* argv[])
+{
+    /* code */
+    scheduler::init();
+
+    submit_to_scheduler(server(8000));
+    scheduler::loop();
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include <string>
+#include <string_view>
+
+#include "bench_helper.hpp"
+#include "benchmark/benchmark.h"
+#include "coro/coro.hpp"
+#include "coro/detail/simd.hpp"
+#include "coro/utils.hpp"
+
+using namespace coro::io::net::http;
+
+// request sent by wrk-like load generator
+static const std::string_view kRequest = "GET /index.html?user=tinycoro HTTP/1.1\r\n"
+                                         "Host: 127.0.0.1:8000\r\n"
+                                         "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36\r\n"
+                                         "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+                                         "Accept-Language: en-US,en;q=0.5\r\n"
+                                         "Accept-Encoding: gzip, deflate\r\n"
+                                         "Connection: keep-alive\r\n"
+                                         "Cache-Control: max-age=0\r\n"
+                                         "\r\n";
+
+/*************************************************************
+ *                       http_parse                          *
+ *************************************************************/
+
+// parse pipelined requests in one buffer, this is what connection does for each read
+static void http_parse(benchmark::State& state)
+{
+    const int   request_num = state.range(0);
+    std::string buf;
+    for (int i = 0; i < request_num; i++)
+    {
+        buf.append(kRequest);
+    }
+
+    request_parser parser;
+    request        req;
+    for (auto _ : state)
+    {
+        std::string_view data(buf);
+        while (!data.empty())
+        {
+            auto status = parser.parse(data, req);
+            benchmark::DoNotOptimize(status);
+            data.remove_prefix(parser.consumed());
+            parser.reset();
+        }
+        benchmark::DoNotOptimize(req.get_header("host"));
+    }
+    state.SetItemsProcessed(state.iterations() * request_num);
+    state.SetBytesProcessed(state.iterations() * buf.size());
+}
+
+CORO_BENCHMARK3(http_parse, 1, 16, 1024);
+
+/*************************************************************
+ *                    http_parse_partial                     *
+ *************************************************************/
+
+// request arrives in small pieces, incremental parser scans every byte once
+static void http_parse_partial(benchmark::State& state)
+{
+    const size_t piece = state.range(0);
+
+    request_parser parser;
+    request        req;
+    for (auto _ : state)
+    {
+        size_t len = 0;
+        while (true)
+        {
+            len         = std::min(len + piece, kRequest.size());
+            auto status = parser.parse(kRequest.substr(0, len), req);
+            if (status != parse_status::partial)
+            {
+                break;
+            }
+        }
+        parser.reset();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+CORO_BENCHMARK2(http_parse_partial, 16, 64);
+
+/*************************************************************
+ *                     http_parse_simd                       *
+ *************************************************************/
+
+// same as http_parse with 1024 requests, arg is the simd level: 0 scalar, 1 sse4.2, 2 avx2
+static void http_parse_simd(benchmark::State& state)
+{
+    using coro::detail::simd_level;
+    namespace simd = coro::detail::simd;
+
+    auto origin = simd::level();
+    auto lv     = simd::set_level(static_cast<simd_level>(state.range(0)));
+    if (lv != static_cast<simd_level>(state.range(0)))
+    {
+        simd::set_level(origin);
+        state.SkipWithError("simd level isn't supported by cpu");
+        return;
+    }
+
+    std::string buf;
+    for (int i = 0; i < 1024; i++)
+    {
+        buf.append(kRequest);
+    }
+
+    request_parser parser;
+    request        req;
+    for (auto _ : state)
+    {
+        std::string_view data(buf);
+        while (!data.empty())
+        {
+            auto status = parser.parse(data, req);
+            benchmark::DoNotOptimize(status);
+            data.remove_prefix(parser.consumed());
+            parser.reset();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+    state.SetBytesProcessed(state.iterations() * buf.size());
+    simd::set_level(origin);
+}
+
+CORO_BENCHMARK3(http_parse_simd, 0, 1, 2);
+
+/*************************************************************
+ *                    http_header_lookup                     *
+ *************************************************************/
+
+// case-insensitive lookup of every header, arg is the simd level like http_parse_simd
+static void http_header_lookup(benchmark::State& state)
+{
+    using coro::detail::simd_level;
+    namespace simd = coro::detail::simd;
+
+    auto origin = simd::level();
+    auto lv     = simd::set_level(static_cast<simd_level>(state.range(0)));
+    if (lv != static_cast<simd_level>(state.range(0)))
+    {
+        simd::set_level(origin);
+        state.SkipWithError("simd level isn't supported by cpu");
+        return;
+    }
+
+    request_parser parser;
+    request        req;
+    parser.parse(kRequest, req);
+
+    constexpr std::string_view names[] = {
+        "host", "user-agent", "accept", "accept-language", "accept-encoding", "connection", "cache-control"};
+    for (auto _ : state)
+    {
+        for (auto name : names)
+        {
+            benchmark::DoNotOptimize(req.get_header(name));
+            benchmark::DoNotOptimize(coro::utils::hash{}(name));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(names));
+    simd::set_level(origin);
+}
+
+CORO_BENCHMARK3(http_header_lookup, 0, 1, 2);
+
+/*************************************************************
+ *                   http_serialize_head                     *
+ *************************************************************/
+
+static void http_serialize_head(benchmark::State& state)
+{
+    request_parser parser;
+    request        req;
+    parser.parse(kRequest, req);
+
+    response    resp;
+    std::string out;
+    for (auto _ : state)
+    {
+        out.clear();
+        resp.reset(req);
+        resp.add_header("Content-Type", "text/plain").set_body_view("hello tinycoro\n");
+        resp.serialize_head(out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+CORO_BENCHMARK(http_serialize_head);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,124 @@
+#include <functional>
+#include <vector>
+
+#include "bench_helper.hpp"
+#include "benchmark/benchmark.h"
+#include "coro/coro.hpp"
+
+using namespace coro;
+using ::coro::io::detail::io_info;
+using ::coro::io::detail::io_type;
+
+/*************************************************************
+ *                 std_function_io_info                      *
+ *************************************************************/
+
+// the old io_info layout, callback is stored in std::function
+struct std_function_io_info
+{
+    std::coroutine_handle<>                          handle;
+    int32_t                                          result;
+    io_type                                          type;
+    uintptr_t                                        data;
+    std::function<void(std_function_io_info*, int)> cb;
+};
+
+static auto std_function_callback(std_function_io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+}
+
+static auto fn_ptr_callback(io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+}
+
+// bind callback and dispatch it once for each io, this is what an awaiter and engine::handle_cqe_entry do
+static void std_function_io_info_dispatch(benchmark::State& state)
+{
+    const int                         io_num = state.range(0);
+    std::vector<std_function_io_info> infos(io_num);
+    for (auto _ : state)
+    {
+        for (auto& info : infos)
+        {
+            info.type = io_type::nop;
+            info.cb   = &std_function_callback;
+        }
+        for (int i = 0; i < io_num; i++)
+        {
+            auto data = &infos[i];
+            benchmark::DoNotOptimize(data);
+            data->cb(data, i);
+        }
+        benchmark::ClobberMemory();
+    }
+}
+
+CORO_BENCHMARK3(std_function_io_info_dispatch, 1000, 100000, 1000000);
+
+/*************************************************************
+ *                    fn_ptr_io_info                         *
+ *************************************************************/
+
+static void fn_ptr_io_info_dispatch(benchmark::State& state)
+{
+    const int            io_num = state.range(0);
+    std::vector<io_info> infos(io_num);
+    for (auto _ : state)
+    {
+        for (auto& info : infos)
+        {
+            info.type = io_type::nop;
+            info.cb   = &fn_ptr_callback;
+        }
+        for (int i = 0; i < io_num; i++)
+        {
+            auto data = &infos[i];
+            benchmark::DoNotOptimize(data);
+            data->cb(data, i);
+        }
+        benchmark::ClobberMemory();
+    }
+}
+
+CORO_BENCHMARK3(fn_ptr_io_info_dispatch, 1000, 100000, 1000000);
+
+/*************************************************************
+ *                    engine_nop_io                          *
+ *************************************************************/
+
+// submit nop io by engine and handle all cqes, measure the whole per-cqe path
+static void engine_nop_io(benchmark::State& state)
+{
+    const int            io_num = state.range(0);
+    detail::engine       engine;
+    std::vector<io_info> infos(config::kEntryLength);
+    engine.init();
+    for (auto _ : state)
+    {
+        for (int done = 0; done < io_num;)
+        {
+            int batch = std::min<int>(io_num - done, config::kEntryLength);
+            for (int i = 0; i < batch; i++)
+            {
+                auto sqe      = engine.get_free_urs();
+                infos[i].type = io_type::nop;
+                infos[i].cb   = &fn_ptr_callback;
+                io_uring_prep_nop(sqe);
+                io_uring_sqe_set_data(sqe, &infos[i]);
+                engine.add_io_submit();
+            }
+            while (!engine.empty_io())
+            {
+                engine.poll_submit();
+            }
+            done += batch;
+        }
+    }
+    engine.deinit();
+}
+
+CORO_BENCHMARK2(engine_nop_io, 10000, 1000000);
+
+BENCHMARK_MAIN();
@@ -108,6 +108,45 @@ static void coro_event(benchmark::State& state)
 
 CORO_BENCHMARK3(coro_event, 100, 100000, 100000000);
 
+/*************************************************************
+ *                   coro_event_broadcast                    *
+ *************************************************************/
+
+// one set wakes all waiters, waiters of the same context are submitted in batches
+task<> broadcast_set(event<>& ev, latch& lt)
+{
+    co_await lt.wait();
+    ev.set();
+}
+
+task<> broadcast_wait(event<>& ev, latch& lt)
+{
+    lt.count_down();
+    co_await ev.wait();
+}
+
+static void coro_event_broadcast(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        const int waiter_num = state.range(0);
+        scheduler::init();
+
+        event<> ev;
+        latch   lt(waiter_num);
+        for (int i = 0; i < waiter_num; i++)
+        {
+            submit_to_scheduler(broadcast_wait(ev, lt));
+        }
+        submit_to_scheduler(broadcast_set(ev, lt));
+
+        scheduler::loop();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+CORO_BENCHMARK1(coro_event_broadcast, 10000);
+
 BENCHMARK_MAIN();
 
 template<typename event_type>
@@ -114,6 +114,42 @@ static void coro_waitgroup(benchmark::State& state)
 
 CORO_BENCHMARK3(coro_waitgroup, 100, 100000, 100000000);
 
+/*************************************************************
+ *                  coro_waitgroup_done                      *
+ *************************************************************/
+
+// one done() per iteration, waiters are resumed by the last done()
+task<> done_many(wait_group& wg, const int done_num)
+{
+    for (int i = 0; i < done_num; i++)
+    {
+        wg.done();
+    }
+    co_return;
+}
+
+static void coro_waitgroup_done(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        const int done_num = state.range(0);
+
+        scheduler::init();
+
+        wait_group wg(done_num);
+        for (int i = 0; i < thread_num; i++)
+        {
+            submit_to_scheduler(wait(wg, 0));
+        }
+        submit_to_scheduler(done_many(wg, done_num));
+
+        scheduler::loop();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+CORO_BENCHMARK1(coro_waitgroup_done, 100000);
+
 BENCHMARK_MAIN();
 
 template<typename waitgroup_type>
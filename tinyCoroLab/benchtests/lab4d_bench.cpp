@@ -113,6 +113,63 @@ static void coro_mutex(benchmark::State& state)
 
 CORO_BENCHMARK3(coro_mutex, 100, 100000, 100000000);
 
+/*************************************************************
+ *                  contention_stl_mutex                     *
+ *************************************************************/
+
+// each coroutine fetches lock lock_num times, critical section is short
+static const int lock_num = 1000;
+
+template<typename mutex_type>
+void mutex_contention_bench(const int coro_num);
+
+static task<> lock_add(std::mutex& mtx, size_t& cnt)
+{
+    for (int i = 0; i < lock_num; i++)
+    {
+        mtx.lock();
+        benchmark::DoNotOptimize(cnt += 1);
+        mtx.unlock();
+    }
+    co_return;
+}
+
+static void contention_stl_mutex(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        const int coro_num = state.range(0);
+        mutex_contention_bench<std::mutex>(coro_num);
+    }
+}
+
+CORO_BENCHMARK3(contention_stl_mutex, 1, 4, 64);
+
+/*************************************************************
+ *                  contention_coro_mutex                    *
+ *************************************************************/
+
+static task<> lock_add(mutex& mtx, size_t& cnt)
+{
+    for (int i = 0; i < lock_num; i++)
+    {
+        co_await mtx.lock();
+        benchmark::DoNotOptimize(cnt += 1);
+        mtx.unlock();
+    }
+}
+
+static void contention_coro_mutex(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        const int coro_num = state.range(0);
+        mutex_contention_bench<mutex>(coro_num);
+    }
+}
+
+CORO_BENCHMARK3(contention_coro_mutex, 1, 4, 64);
+
 BENCHMARK_MAIN();
 
 template<typename mutex_type>
@@ -129,3 +186,20 @@ void mutex_bench(const int loop_num)
 
     scheduler::loop();
 }
+
+template<typename mutex_type>
+void mutex_contention_bench(const int coro_num)
+{
+    scheduler::init();
+
+    mutex_type mtx;
+    size_t     cnt{0};
+
+    for (int i = 0; i < coro_num; i++)
+    {
+        submit_to_scheduler(lock_add(mtx, cnt));
+    }
+
+    scheduler::loop();
+    assert(cnt == size_t(coro_num) * lock_num);
+}
@@ -0,0 +1,171 @@
+#include <vector>
+
+#include "bench_helper.hpp"
+#include "benchmark/benchmark.h"
+#include "coro/coro.hpp"
+
+using namespace coro;
+
+// every benchmark round fans in total_child children, so time / total_child is the cost per child
+static const int total_child = 100000;
+
+template<typename driver_type>
+void when_all_bench(driver_type driver, const int child_num);
+
+task<int> child(int i)
+{
+    co_return i;
+}
+
+/*************************************************************
+ *                     sequential_await                      *
+ *************************************************************/
+
+// baseline: co_await children one by one
+task<> sequential_await_driver(const int child_num)
+{
+    for (int round = 0; round < total_child / child_num; round++)
+    {
+        std::vector<task<int>> children;
+        children.reserve(child_num);
+        for (int i = 0; i < child_num; i++)
+        {
+            children.emplace_back(child(i));
+        }
+        for (auto& c : children)
+        {
+            benchmark::DoNotOptimize(co_await c);
+        }
+    }
+}
+
+static void sequential_await(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        when_all_bench(sequential_await_driver, state.range(0));
+    }
+    state.SetItemsProcessed(state.iterations() * total_child);
+}
+
+CORO_BENCHMARK3(sequential_await, 1, 16, 1024);
+
+/*************************************************************
+ *                      when_all_range                       *
+ *************************************************************/
+
+task<> when_all_range_driver(const int child_num)
+{
+    for (int round = 0; round < total_child / child_num; round++)
+    {
+        std::vector<task<int>> children;
+        children.reserve(child_num);
+        for (int i = 0; i < child_num; i++)
+        {
+            children.emplace_back(child(i));
+        }
+        auto results = co_await when_all(children);
+        benchmark::DoNotOptimize(results);
+    }
+}
+
+static void when_all_range(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        when_all_bench(when_all_range_driver, state.range(0));
+    }
+    state.SetItemsProcessed(state.iterations() * total_child);
+}
+
+CORO_BENCHMARK3(when_all_range, 1, 16, 1024);
+
+/*************************************************************
+ *                    when_all_variadic                      *
+ *************************************************************/
+
+task<> when_all_variadic_driver(const int child_num)
+{
+    for (int round = 0; round < total_child / 4; round++)
+    {
+        auto results = co_await when_all(child(0), child(1), child(2), child(3));
+        benchmark::DoNotOptimize(results);
+    }
+}
+
+static void when_all_variadic(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        when_all_bench(when_all_variadic_driver, 4);
+    }
+    state.SetItemsProcessed(state.iterations() * total_child);
+}
+
+CORO_BENCHMARK(when_all_variadic);
+
+/*************************************************************
+ *                   when_all_range_policy                   *
+ *************************************************************/
+
+// cpu bound child, makes the difference between running on one context and all contexts visible
+task<long> heavy_child(int i)
+{
+    long sum = 0;
+    for (int k = 0; k < 10000; k++)
+    {
+        benchmark::DoNotOptimize(sum += k ^ i);
+    }
+    co_return sum;
+}
+
+template<launch_policy policy>
+task<> when_all_policy_driver(const int child_num)
+{
+    std::vector<task<long>> children;
+    children.reserve(child_num);
+    for (int i = 0; i < child_num; i++)
+    {
+        children.emplace_back(heavy_child(i));
+    }
+    auto results = co_await when_all(children, policy);
+    benchmark::DoNotOptimize(results);
+}
+
+static void when_all_range_local(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        scheduler::init();
+        submit_to_scheduler(when_all_policy_driver<launch_policy::local>(state.range(0)));
+        scheduler::loop();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+CORO_BENCHMARK1(when_all_range_local, 1024);
+
+static void when_all_range_scatter(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        scheduler::init();
+        submit_to_scheduler(when_all_policy_driver<launch_policy::scatter>(state.range(0)));
+        scheduler::loop();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+CORO_BENCHMARK1(when_all_range_scatter, 1024);
+
+BENCHMARK_MAIN();
+
+template<typename driver_type>
+void when_all_bench(driver_type driver, const int child_num)
+{
+    scheduler::init(1);
+
+    submit_to_scheduler(driver(child_num));
+
+    scheduler::loop();
+}
@@ -2,8 +2,10 @@
 #include <condition_variable>
 #include <mutex>
 #include <queue>
+#include <span>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "bench_helper.hpp"
 #include "benchmark/benchmark.h"
@@ -227,6 +229,81 @@ static void coro_channel_string(benchmark::State& state)
 
 CORO_BENCHMARK2(coro_channel_string, 100, 10000);
 
+/*************************************************************
+ *                       batch channel                       *
+ *************************************************************/
+
+template<typename return_type>
+task<> channel_batch_producer(channel<return_type, capacity>& ch, int total_num)
+{
+    std::vector<return_type> values;
+    values.reserve(capacity);
+    for (int i = 0; i < total_num; i += capacity)
+    {
+        values.clear();
+        for (int j = 0; j < capacity; j++)
+        {
+            if constexpr (std::is_same_v<return_type, std::string>)
+            {
+                values.push_back(std::string(bench_str));
+            }
+            else
+            {
+                values.push_back(return_type{});
+            }
+        }
+        co_await ch.send_batch(std::span<return_type>(values));
+    }
+    ch.close();
+}
+
+template<typename return_type>
+task<> channel_batch_consumer(channel<return_type, capacity>& ch)
+{
+    while (true)
+    {
+        auto data = co_await ch.recv_batch(capacity);
+        if (data.empty())
+        {
+            break;
+        }
+    }
+}
+
+template<typename return_type>
+void channel_batch_bench(const int loop_num)
+{
+    scheduler::init();
+
+    channel<return_type, capacity> ch;
+    submit_to_scheduler(channel_batch_producer(ch, loop_num * capacity));
+    submit_to_scheduler(channel_batch_consumer(ch));
+
+    scheduler::loop();
+}
+
+static void coro_channel_batch_int(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        const int loop_num = state.range(0);
+        channel_batch_bench<int>(loop_num);
+    }
+}
+
+CORO_BENCHMARK2(coro_channel_batch_int, 100, 10000);
+
+static void coro_channel_batch_string(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        const int loop_num = state.range(0);
+        channel_batch_bench<std::string>(loop_num);
+    }
+}
+
+CORO_BENCHMARK2(coro_channel_batch_string, 100, 10000);
+
 BENCHMARK_MAIN();
 
 template<typename channel_type, typename return_type>
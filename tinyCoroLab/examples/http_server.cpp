@@ -0,0 +1,36 @@
+#include "coro/coro.hpp"
+
+using namespace coro;
+using namespace coro::io::net::http;
+
+using coro::time::timer;
+
+task<> delay_handler(const request& req, response& resp)
+{
+    co_await timer{}.add_mseconds(100);
+    resp.set_body("delayed " + std::string(req.get_query()) + "\n");
+}
+
+int main(int argc, char const* argv[])
+{
+    /* code */
+    http_server server(8000);
+    server.get_router()
+        .get("/", [](const request&, response& resp) { resp.set_body_view("hello tinycoro\n"); })
+        .post(
+            "/echo",
+            [](const request& req, response& resp)
+            {
+                // body refers to the read buffer, it's alive until the response is sent
+                resp.add_header("Content-Type", "text/plain").set_body_view(req.get_body());
+            })
+        .get(
+            "/static/*",
+            [](const request& req, response& resp) { resp.set_body("static file: " + std::string(req.get_path()) + "\n"); })
+        .get("/delay", delay_handler);
+
+    scheduler::init();
+    submit_to_scheduler(server.serve());
+    scheduler::loop();
+    return 0;
+}
@@ -4,6 +4,8 @@ using namespace coro;
 
 task<int> square(int i)
 {
+    // parallel_func 默认把子任务分散到所有 context 上执行
+    log::info("context {} calc square of {}", local_context().get_ctx_id(), i);
     co_return i* i;
 }
 
@@ -16,17 +18,25 @@ task<> parallel_compute()
     }
     auto answer = co_await parallel::parallel_func(
         vec,
-        parallel::make_parallel_reduce_func(
-            [](std::vector<int>& vec)
+        [](const std::vector<int>& vec)
+        {
+            int sum = 0;
+            for (auto it : vec)
             {
-                int sum = 0;
-                for (auto it : vec)
-                {
-                    sum += it;
-                }
-                return sum;
-            }));
+                sum += it;
+            }
+            return sum;
+        });
     log::info("final answer: {}", answer);
+
+    vec.clear();
+    for (int i = 1; i <= 5; i++)
+    {
+        vec.push_back(square(i));
+    }
+    // 二元 op 直接合并结果，算术类型且 op 可交换时走 std::reduce
+    answer = co_await parallel::parallel_func(vec, std::plus<>{});
+    log::info("final answer by std::plus: {}", answer);
 }
 
 int main(int argc, char const* argv[])
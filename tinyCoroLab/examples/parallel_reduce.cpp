@@ -0,0 +1,27 @@
+#include <numeric>
+
+#include "coro/coro.hpp"
+
+using namespace coro;
+
+task<> batch_score()
+{
+    std::vector<int> scores(100000);
+    std::iota(scores.begin(), scores.end(), 0);
+
+    // 每个 context 处理一段，而不是每个元素一个协程
+    co_await parallel::for_each(scores, 0, [](int& score) { score = score % 100; });
+
+    auto total = co_await parallel::reduce(scores, 0L);
+    auto best  = co_await parallel::reduce(scores, 0, [](int a, int b) { return std::max(a, b); });
+    log::info("total score: {}, best score: {}", total, best);
+}
+
+int main(int argc, char const* argv[])
+{
+    /* code */
+    scheduler::init();
+    submit_to_scheduler(batch_score());
+    scheduler::loop();
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include "coro/coro.hpp"
+
+using namespace coro;
+
+channel<int> data_ch;
+channel<int> ctrl_ch;
+event<>      stop_ev;
+
+task<> producer()
+{
+    for (int i = 0; i < 5; i++)
+    {
+        co_await data_ch.send(i);
+    }
+    co_await ctrl_ch.send(-1);
+    log::info("producer ready to sleep");
+    utils::sleep(1);
+    stop_ev.set();
+    co_return;
+}
+
+task<> consumer()
+{
+    while (true)
+    {
+        auto res = co_await select(data_ch.recv(), ctrl_ch.recv(), stop_ev.wait());
+        switch (res.index())
+        {
+            case 0:
+                log::info("consumer receive data: {}", *std::get<0>(res));
+                break;
+            case 1:
+                log::info("consumer receive control: {}", *std::get<1>(res));
+                break;
+            default:
+                log::info("consumer wake up by stop event");
+                co_return;
+        }
+    }
+}
+
+int main(int argc, char const* argv[])
+{
+    /* code */
+    scheduler::init();
+
+    submit_to_scheduler(consumer());
+    submit_to_scheduler(producer());
+
+    scheduler::loop();
+    return 0;
+}
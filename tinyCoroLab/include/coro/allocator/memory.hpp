@@ -1,9 +1,19 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
 
 #include "config.h"
+#include "coro/allocator/profiler.hpp"
 #include "coro/attribute.hpp"
 #include "coro/detail/types.hpp"
 
@@ -38,7 +48,7 @@ public:
  * @tparam
  */
 template<>
-class memory_allocator<coro::config::kMemoryAllocator>
+class memory_allocator<coro::detail::memory_allocator::std_allocator>
 {
 public:
     struct config
@@ -55,6 +65,391 @@ public:
     auto release(void* ptr) -> void CORO_INLINE { free(ptr); }
 };
 
+namespace detail
+{
+struct slab_cache;
+
+/**
+ * @brief every block allocated by slab allocator is prefixed by this header,
+ * 16 bytes keep the returned memory aligned to __STDCPP_DEFAULT_NEW_ALIGNMENT__
+ *
+ */
+struct alignas(16) slab_header
+{
+    slab_cache* owner;      // nullptr means the block is allocated by malloc directly
+    uint32_t    size_class; // index of size class
+    uint32_t    block_size; // block size including header
+};
+
+// free block reuses the memory after header to link next free block
+struct slab_node
+{
+    slab_node* next;
+};
+
+inline constexpr size_t kSlabHeaderSize = sizeof(slab_header);
+inline constexpr size_t kSlabMaxClasses = 32;
+inline constexpr size_t kSlabGranule    = 16;
+
+inline auto node_to_header(slab_node* node) noexcept -> slab_header*
+{
+    return reinterpret_cast<slab_header*>(node) - 1;
+}
+
+inline auto header_to_node(slab_header* header) noexcept -> slab_node*
+{
+    return reinterpret_cast<slab_node*>(header + 1);
+}
+
+/**
+ * @brief size class table maps the requested size to size class index in O(1)
+ *
+ */
+struct slab_size_table
+{
+    size_t                                                                 num_classes{0};
+    std::array<uint32_t, kSlabMaxClasses>                                  class_size{};
+    std::array<uint8_t, coro::config::kSlabMaxBlockSize / kSlabGranule + 1> index{};
+
+    /**
+     * @brief build table by size classes, each size class is the block size including header
+     *
+     * @param sizes must be sorted in ascending order
+     */
+    auto build(const std::vector<size_t>& sizes) noexcept -> void
+    {
+        num_classes = 0;
+        for (auto size : sizes)
+        {
+            size = (size + kSlabGranule - 1) / kSlabGranule * kSlabGranule;
+            if (size <= kSlabHeaderSize || size > coro::config::kSlabMaxBlockSize || num_classes == kSlabMaxClasses ||
+                (num_classes > 0 && class_size[num_classes - 1] >= size))
+            {
+                continue;
+            }
+            class_size[num_classes++] = size;
+        }
+
+        size_t cls = 0;
+        for (size_t i = 0; i < index.size(); i++)
+        {
+            while (cls < num_classes && class_size[cls] < i * kSlabGranule)
+            {
+                cls++;
+            }
+            index[i] = cls; // cls == num_classes means no size class fits
+        }
+    }
+
+    // return num_classes if block_size can't be served by size classes
+    inline auto lookup(size_t block_size) const noexcept -> size_t CORO_INLINE
+    {
+        if (block_size > coro::config::kSlabMaxBlockSize)
+        {
+            return num_classes;
+        }
+        return index[(block_size + kSlabGranule - 1) / kSlabGranule];
+    }
+
+    static auto default_sizes() noexcept -> std::vector<size_t>
+    {
+        std::vector<size_t> sizes;
+        for (size_t size = coro::config::kSlabMinBlockSize; size <= coro::config::kSlabMaxBlockSize; size <<= 1)
+        {
+            sizes.push_back(size);
+        }
+        return sizes;
+    }
+};
+
+/**
+ * @brief per thread free lists of each size class, blocks released by other threads are pushed to
+ * remote stack and drained by the owner thread when its local free list is empty
+ *
+ */
+struct slab_cache
+{
+    std::array<slab_node*, kSlabMaxClasses> free_list{};
+
+    alignas(coro::config::kCacheLineSize) std::atomic<slab_node*> remote_head{nullptr};
+
+    // called by other threads, lock-free push
+    auto push_remote(slab_node* node) noexcept -> void
+    {
+        auto head = remote_head.load(std::memory_order_relaxed);
+        do
+        {
+            node->next = head;
+        } while (!remote_head.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // called by owner thread, take all remote blocks back to local free lists at once
+    auto drain_remote() noexcept -> bool
+    {
+        auto node = remote_head.exchange(nullptr, std::memory_order_acquire);
+        if (node == nullptr)
+        {
+            return false;
+        }
+        while (node != nullptr)
+        {
+            auto next  = node->next;
+            auto cls   = node_to_header(node)->size_class;
+            node->next = free_list[cls];
+            free_list[cls] = node;
+            node           = next;
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief slab_cache is bound to thread by thread_local holder, when thread exits, the cache is
+ * given back to global pool rather than destroyed, so remote release after thread exits is still safe
+ *
+ */
+class slab_cache_pool
+{
+public:
+    static auto acquire() -> slab_cache*
+    {
+        std::lock_guard lock(mutex());
+        auto&           caches = free_caches();
+        if (caches.empty())
+        {
+            return new slab_cache();
+        }
+        auto cache = caches.back();
+        caches.pop_back();
+        return cache;
+    }
+
+    static auto give_back(slab_cache* cache) noexcept -> void
+    {
+        std::lock_guard lock(mutex());
+        free_caches().push_back(cache);
+    }
+
+    // chunks are never freed, record them so that they are always reachable
+    static auto alloc_chunk(size_t size) -> void*
+    {
+        auto chunk = malloc(size);
+        if (chunk == nullptr) [[unlikely]]
+        {
+            throw std::bad_alloc();
+        }
+        std::lock_guard lock(mutex());
+        chunks().push_back(chunk);
+        return chunk;
+    }
+
+private:
+    static auto mutex() noexcept -> std::mutex&
+    {
+        static std::mutex m;
+        return m;
+    }
+
+    // never destroyed, thread may still release frames during static destruction
+    static auto free_caches() noexcept -> std::vector<slab_cache*>&
+    {
+        static auto caches = new std::vector<slab_cache*>();
+        return *caches;
+    }
+
+    static auto chunks() noexcept -> std::vector<void*>&
+    {
+        static auto chunks = new std::vector<void*>();
+        return *chunks;
+    }
+};
+
+struct slab_cache_holder
+{
+    slab_cache* cache{nullptr};
+
+    ~slab_cache_holder()
+    {
+        if (cache != nullptr)
+        {
+            slab_cache_pool::give_back(cache);
+        }
+    }
+};
+
+inline thread_local slab_cache_holder local_slab_cache;
+
+inline auto get_local_slab_cache() -> slab_cache*
+{
+    if (local_slab_cache.cache == nullptr) [[unlikely]]
+    {
+        local_slab_cache.cache = slab_cache_pool::acquire();
+    }
+    return local_slab_cache.cache;
+}
+}; // namespace detail
+
+/**
+ * @brief slab memory allocator, coroutine frames are served by per thread size class free lists,
+ * frames released by other threads are returned to the owner thread through a lock-free remote
+ * stack, frames larger than the biggest size class fall back to malloc
+ *
+ * @note memory of size classes is never given back to system
+ * @note allocate throws std::bad_alloc like operator new if system runs out of memory
+ *
+ * @tparam
+ */
+template<>
+class memory_allocator<coro::detail::memory_allocator::slab>
+{
+public:
+    struct config
+    {
+        // block sizes including header, empty means power of 2 from kSlabMinBlockSize to kSlabMaxBlockSize
+        std::vector<size_t> size_classes;
+        // memory size that one thread carves blocks from at a time
+        size_t chunk_size{coro::config::kSlabChunkSize};
+        // if size_classes is empty, derive size classes from this frame profile file
+        std::string profile_file{
+            coro::config::kSlabUseProfile ? std::string(SOURCE_DIR) + coro::config::kMemoryProfileFile : ""};
+        // the max number of size classes derived from profile
+        size_t profile_class_num{coro::config::kSlabProfileClassNum};
+    };
+
+public:
+    ~memory_allocator() = default;
+
+    /**
+     * @brief set size classes, size classes can't be changed after the first block is allocated
+     *
+     * @param config
+     */
+    auto init(config config) -> void
+    {
+        auto sizes = config.size_classes;
+        if (sizes.empty() && !config.profile_file.empty())
+        {
+            sizes = derive_size_classes(
+                frame_profile::load(config.profile_file),
+                std::min(config.profile_class_num, detail::kSlabMaxClasses),
+                detail::kSlabHeaderSize,
+                coro::config::kSlabMaxBlockSize);
+        }
+        if (sizes.empty())
+        {
+            sizes = detail::slab_size_table::default_sizes();
+        }
+        std::sort(sizes.begin(), sizes.end());
+
+        detail::slab_size_table table;
+        table.build(sizes);
+        if (table.num_classes == 0)
+        {
+            return;
+        }
+        s_chunk_size = config.chunk_size;
+        if (!s_used.load(std::memory_order_acquire))
+        {
+            size_table() = table;
+        }
+    }
+
+    auto allocate(size_t size) -> void* CORO_INLINE
+    {
+        auto  block_size = size + detail::kSlabHeaderSize;
+        auto& table      = size_table();
+        auto  cls        = table.lookup(block_size);
+        if (cls == table.num_classes) [[unlikely]]
+        {
+            auto header = static_cast<detail::slab_header*>(malloc(block_size));
+            if (header == nullptr) [[unlikely]]
+            {
+                throw std::bad_alloc();
+            }
+            header->owner      = nullptr;
+            header->size_class = 0;
+            header->block_size = block_size;
+            return header + 1;
+        }
+
+        auto cache = detail::get_local_slab_cache();
+        auto node  = cache->free_list[cls];
+        if (node == nullptr) [[unlikely]]
+        {
+            node = refill(cache, cls);
+        }
+        cache->free_list[cls] = node->next;
+        return node;
+    }
+
+    auto release(void* ptr) -> void CORO_INLINE
+    {
+        auto node   = static_cast<detail::slab_node*>(ptr);
+        auto header = detail::node_to_header(node);
+        if (header->owner == nullptr) [[unlikely]]
+        {
+            free(header);
+            return;
+        }
+
+        auto cache = detail::get_local_slab_cache();
+        if (header->owner == cache) [[likely]]
+        {
+            node->next                           = cache->free_list[header->size_class];
+            cache->free_list[header->size_class] = node;
+        }
+        else
+        {
+            // frame is destroyed on another context, return it to the owner
+            header->owner->push_remote(node);
+        }
+    }
+
+private:
+    static auto size_table() noexcept -> detail::slab_size_table&
+    {
+        static detail::slab_size_table table = []()
+        {
+            detail::slab_size_table t;
+            t.build(detail::slab_size_table::default_sizes());
+            return t;
+        }();
+        return table;
+    }
+
+    // fetch remote released blocks first, carve a new chunk if there is still no free block
+    static auto refill(detail::slab_cache* cache, size_t cls) -> detail::slab_node*
+    {
+        if (cache->drain_remote() && cache->free_list[cls] != nullptr)
+        {
+            return cache->free_list[cls];
+        }
+
+        s_used.store(true, std::memory_order_release);
+        size_t block_size = size_table().class_size[cls];
+        size_t num        = std::max<size_t>(s_chunk_size / block_size, 1);
+        auto   chunk      = static_cast<std::byte*>(detail::slab_cache_pool::alloc_chunk(num * block_size));
+
+        detail::slab_node* head = nullptr;
+        for (size_t i = num; i > 0; i--)
+        {
+            auto header        = reinterpret_cast<detail::slab_header*>(chunk + (i - 1) * block_size);
+            header->owner      = cache;
+            header->size_class = cls;
+            header->block_size = block_size;
+            auto node          = detail::header_to_node(header);
+            node->next         = head;
+            head               = node;
+        }
+        cache->free_list[cls] = head;
+        return head;
+    }
+
+private:
+    inline static std::atomic<bool> s_used{false};
+    inline static size_t            s_chunk_size{coro::config::kSlabChunkSize};
+};
+
 // This config type is used to provide for outsides
 using mem_alloc_config = memory_allocator<coro::config::kMemoryAllocator>::config;
 
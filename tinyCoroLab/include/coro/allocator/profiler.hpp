@@ -0,0 +1,365 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "config.h"
+#include "coro/attribute.hpp"
+
+namespace coro::allocator::memory
+{
+/**
+ * @brief histogram of coroutine frame size, size is rounded up to kGranule
+ *
+ */
+struct frame_profile
+{
+    static constexpr size_t kGranule = 16;
+
+    std::vector<std::pair<size_t, uint64_t>> sizes; // (frame size, count), ascending by frame size
+
+    auto empty() const noexcept -> bool { return sizes.empty(); }
+
+    /**
+     * @brief save profile as text, each line is "size count"
+     *
+     * @param path
+     * @return true if save successfully
+     */
+    auto save(const std::string& path) const noexcept -> bool
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+        std::ofstream out(path, std::ios::trunc);
+        if (!out)
+        {
+            return false;
+        }
+        for (auto& [size, count] : sizes)
+        {
+            out << size << ' ' << count << '\n';
+        }
+        return static_cast<bool>(out);
+    }
+
+    /**
+     * @brief load profile saved by save()
+     *
+     * @param path
+     * @return frame_profile, empty if the file doesn't exist
+     */
+    static auto load(const std::string& path) noexcept -> frame_profile
+    {
+        frame_profile profile;
+        std::ifstream in(path);
+        size_t        size;
+        uint64_t      count;
+        while (in >> size >> count)
+        {
+            if (count > 0)
+            {
+                profile.sizes.emplace_back(size, count);
+            }
+        }
+        std::sort(profile.sizes.begin(), profile.sizes.end());
+        return profile;
+    }
+};
+
+/**
+ * @brief derive at most max_classes size classes which minimize the wasted bytes of profile,
+ * a size class is the block size including header_size, frame bigger than max_block_size is ignored
+ *
+ * @param profile
+ * @param max_classes
+ * @param header_size
+ * @param max_block_size
+ * @return std::vector<size_t> ascending size classes, empty if profile is empty
+ */
+inline auto derive_size_classes(
+    const frame_profile& profile, size_t max_classes, size_t header_size, size_t max_block_size) noexcept
+    -> std::vector<size_t>
+{
+    // merge frames which have the same block size
+    std::vector<std::pair<size_t, uint64_t>> blocks;
+    for (auto& [size, count] : profile.sizes)
+    {
+        auto block = (size + header_size + frame_profile::kGranule - 1) / frame_profile::kGranule * frame_profile::kGranule;
+        if (block > max_block_size || count == 0)
+        {
+            continue;
+        }
+        if (!blocks.empty() && blocks.back().first == block)
+        {
+            blocks.back().second += count;
+        }
+        else
+        {
+            blocks.emplace_back(block, count);
+        }
+    }
+
+    const size_t n = blocks.size();
+    if (n == 0 || max_classes == 0)
+    {
+        return {};
+    }
+    if (n <= max_classes)
+    {
+        std::vector<size_t> classes;
+        for (auto& [block, _] : blocks)
+        {
+            classes.push_back(block);
+        }
+        return classes;
+    }
+
+    // prefix sum of count and count * block size
+    std::vector<uint64_t> cnt(n + 1, 0);
+    std::vector<uint64_t> bytes(n + 1, 0);
+    for (size_t i = 0; i < n; i++)
+    {
+        cnt[i + 1]   = cnt[i] + blocks[i].second;
+        bytes[i + 1] = bytes[i] + blocks[i].second * blocks[i].first;
+    }
+    // wasted bytes if blocks in [l, r] are served by size class blocks[r]
+    auto waste = [&](size_t l, size_t r) -> uint64_t
+    { return blocks[r].first * (cnt[r + 1] - cnt[l]) - (bytes[r + 1] - bytes[l]); };
+
+    // dp[k][j]: min wasted bytes of blocks [0, j] served by k + 1 size classes, the biggest one is blocks[j]
+    constexpr uint64_t                 kInf = std::numeric_limits<uint64_t>::max();
+    std::vector<std::vector<uint64_t>> dp(max_classes, std::vector<uint64_t>(n, kInf));
+    std::vector<std::vector<size_t>>   from(max_classes, std::vector<size_t>(n, 0));
+    for (size_t j = 0; j < n; j++)
+    {
+        dp[0][j] = waste(0, j);
+    }
+    for (size_t k = 1; k < max_classes; k++)
+    {
+        for (size_t j = k; j < n; j++)
+        {
+            for (size_t p = k - 1; p < j; p++)
+            {
+                if (dp[k - 1][p] == kInf)
+                {
+                    continue;
+                }
+                auto cost = dp[k - 1][p] + waste(p + 1, j);
+                if (cost < dp[k][j])
+                {
+                    dp[k][j]   = cost;
+                    from[k][j] = p;
+                }
+            }
+        }
+    }
+
+    std::vector<size_t> classes;
+    size_t              j = n - 1;
+    for (size_t k = max_classes; k > 0; k--)
+    {
+        classes.push_back(blocks[j].first);
+        if (k == 1)
+        {
+            break;
+        }
+        j = from[k - 1][j];
+    }
+    std::reverse(classes.begin(), classes.end());
+    return classes;
+}
+
+/**
+ * @brief live and peak number of frames allocated by one context
+ *
+ */
+struct frame_stat
+{
+    int      ctx_id; // -1 means the thread is not a context
+    int64_t  live;
+    int64_t  peak;
+    uint64_t total;
+};
+
+/**
+ * @brief instrumentation of coroutine frame allocation, each thread records its own counters and
+ * histogram, so recording doesn't contend between threads, the snapshot is merged when reading
+ *
+ * @note only used when ENABLE_MEMORY_PROFILE is defined
+ */
+class frame_profiler
+{
+    static constexpr size_t kBucketNum = coro::config::kSlabMaxBlockSize / frame_profile::kGranule + 1;
+
+    struct CORO_ALIGN local_counter
+    {
+        std::atomic<int>      ctx_id{-1};
+        std::atomic<int64_t>  live{0}; // release may happen in other thread
+        std::atomic<int64_t>  peak{0};
+        std::atomic<uint64_t> total{0};
+
+        // only written by owner thread, index kBucketNum means frame is bigger than kSlabMaxBlockSize
+        std::array<std::atomic<uint64_t>, kBucketNum + 1> histogram{};
+        std::atomic<size_t>                               max_size{0};
+    };
+
+    // frame is prefixed by this header in profile mode
+    struct alignas(16) frame_header
+    {
+        local_counter* counter;
+        size_t         size;
+    };
+
+public:
+    static auto instance() noexcept -> frame_profiler&
+    {
+        // never destroyed, frames may be released during static destruction
+        static auto profiler = new frame_profiler();
+        return *profiler;
+    }
+
+    /**
+     * @brief allocate frame by alloc and record its size
+     *
+     * @tparam allocator
+     * @param alloc
+     * @param size
+     * @return void*
+     */
+    template<typename allocator>
+    static auto allocate(allocator* alloc, size_t size) -> void*
+    {
+        auto header     = static_cast<frame_header*>(alloc->allocate(size + sizeof(frame_header)));
+        header->counter = instance().record_alloc(size);
+        header->size    = size;
+        return header + 1;
+    }
+
+    template<typename allocator>
+    static auto release(allocator* alloc, void* ptr) noexcept -> void
+    {
+        auto header = static_cast<frame_header*>(ptr) - 1;
+        header->counter->live.fetch_sub(1, std::memory_order_relaxed);
+        alloc->release(header);
+    }
+
+    /**
+     * @brief label the counter of current thread with context id
+     *
+     * @param ctx_id
+     */
+    auto bind_context(int ctx_id) noexcept -> void { get_local().ctx_id.store(ctx_id, std::memory_order_relaxed); }
+
+    /**
+     * @brief merge histogram of all threads
+     *
+     * @return frame_profile
+     */
+    auto profile() noexcept -> frame_profile
+    {
+        std::array<uint64_t, kBucketNum + 1> merged{};
+        size_t                               max_size = 0;
+        {
+            std::lock_guard lock(m_mtx);
+            for (auto counter : m_counters)
+            {
+                for (size_t i = 0; i <= kBucketNum; i++)
+                {
+                    merged[i] += counter->histogram[i].load(std::memory_order_relaxed);
+                }
+                max_size = std::max(max_size, counter->max_size.load(std::memory_order_relaxed));
+            }
+        }
+
+        frame_profile profile;
+        for (size_t i = 0; i < kBucketNum; i++)
+        {
+            if (merged[i] > 0)
+            {
+                profile.sizes.emplace_back(i * frame_profile::kGranule, merged[i]);
+            }
+        }
+        if (merged[kBucketNum] > 0)
+        {
+            // frames bigger than kSlabMaxBlockSize are only recorded by the max one
+            profile.sizes.emplace_back(max_size, merged[kBucketNum]);
+        }
+        return profile;
+    }
+
+    /**
+     * @brief live/peak frames of each thread which has allocated frame
+     *
+     * @return std::vector<frame_stat>
+     */
+    auto stats() noexcept -> std::vector<frame_stat>
+    {
+        std::vector<frame_stat> stats;
+        std::lock_guard         lock(m_mtx);
+        for (auto counter : m_counters)
+        {
+            stats.push_back(frame_stat{
+                .ctx_id = counter->ctx_id.load(std::memory_order_relaxed),
+                .live   = counter->live.load(std::memory_order_relaxed),
+                .peak   = counter->peak.load(std::memory_order_relaxed),
+                .total  = counter->total.load(std::memory_order_relaxed)});
+        }
+        return stats;
+    }
+
+private:
+    frame_profiler() noexcept = default;
+
+    auto get_local() noexcept -> local_counter&
+    {
+        // counter is never freed, because frame may be released after thread exits
+        thread_local local_counter* counter = nullptr;
+        if (counter == nullptr) [[unlikely]]
+        {
+            counter = new local_counter();
+            std::lock_guard lock(m_mtx);
+            m_counters.push_back(counter);
+        }
+        return *counter;
+    }
+
+    auto record_alloc(size_t size) noexcept -> local_counter*
+    {
+        auto& counter = get_local();
+        auto  idx     = (size + frame_profile::kGranule - 1) / frame_profile::kGranule;
+        if (idx >= kBucketNum)
+        {
+            idx = kBucketNum;
+            if (size > counter.max_size.load(std::memory_order_relaxed))
+            {
+                counter.max_size.store(size, std::memory_order_relaxed);
+            }
+        }
+        // owner thread is the only writer of histogram and total, so load + store is enough
+        counter.histogram[idx].store(counter.histogram[idx].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        counter.total.store(counter.total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        auto live = counter.live.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (live > counter.peak.load(std::memory_order_relaxed))
+        {
+            counter.peak.store(live, std::memory_order_relaxed);
+        }
+        return &counter;
+    }
+
+private:
+    std::mutex                  m_mtx;
+    std::vector<local_counter*> m_counters;
+};
+
+}; // namespace coro::allocator::memory
@@ -1,4 +1,6 @@
+#include <atomic>
 #include <cstddef>
+#include <type_traits>
 
 #include "config.h"
 
@@ -23,4 +25,81 @@ struct CapacityToConstructor : Queue
 template<typename T>
 using AtomicQueue =
     CapacityToConstructor<atomic_queue::AtomicQueueB2<T, std::allocator<T>, true, false, false>, config::kQueCap>;
-}; // namespace coro::detail
\ No newline at end of file
+
+/**
+ * @brief bounded single producer multi consumer ring queue, only the owner thread can push,
+ * but any thread can pop, so other threads can steal elements from it
+ *
+ * @tparam T storage_type, must be trivially copyable
+ * @tparam Capacity must be power of 2
+ */
+template<typename T, size_t Capacity>
+class SpmcQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "SpmcQueue capacity must be power of 2");
+    static_assert(std::is_trivially_copyable_v<T>, "SpmcQueue element must be trivially copyable");
+
+    static constexpr size_t kMask = Capacity - 1;
+
+public:
+    /**
+     * @brief push one element, only the owner thread can call this
+     *
+     * @return false if queue is full
+     */
+    auto try_push(T val) noexcept -> bool
+    {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) >= Capacity)
+        {
+            return false;
+        }
+        m_buf[tail & kMask].store(val, std::memory_order_relaxed);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief pop one element, thread safe
+     *
+     * @return false if queue is empty
+     */
+    auto try_pop(T& val) noexcept -> bool
+    {
+        auto head = m_head.load(std::memory_order_acquire);
+        while (head != m_tail.load(std::memory_order_acquire))
+        {
+            // the slot can't be overwritten before head moves, so read it before cas
+            val = m_buf[head & kMask].load(std::memory_order_relaxed);
+            if (m_head.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto was_size() const noexcept -> size_t
+    {
+        auto head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+
+    auto was_empty() const noexcept -> bool { return was_size() == 0; }
+
+    /**
+     * @brief drop all elements, not thread safe
+     *
+     */
+    auto reset() noexcept -> void
+    {
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    alignas(config::kCacheLineSize) std::atomic<size_t> m_head{0};
+    alignas(config::kCacheLineSize) std::atomic<size_t> m_tail{0};
+    std::atomic<T> m_buf[Capacity];
+};
+}; // namespace coro::detail
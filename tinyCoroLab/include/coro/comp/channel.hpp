@@ -10,22 +10,30 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <bit>
+#include <cassert>
 #include <cstddef>
+#include <new>
 #include <optional>
+#include <span>
+#include <vector>
 
 #include "coro/comp/condition_variable.hpp"
 #include "coro/comp/mutex.hpp"
 #include "coro/concepts/common.hpp"
+#include "coro/context.hpp"
+#include "coro/detail/select_state.hpp"
+#include "coro/spinlock.hpp"
 #include "coro/task.hpp"
 
 namespace coro
 {
 /**
  * @brief Welcome to tinycoro lab5c, in this part you will build the basic coroutine
- * synchronization componentchannel by modifing channel.hpp and channel.cpp.
+ * synchronization component����channel by modifing channel.hpp and channel.cpp.
  * Please ensure you have read the document of lab5c.
  *
  * @warning You should carefully consider whether each implementation should be thread-safe.
@@ -40,28 +48,765 @@ namespace coro
  */
 namespace detail
 {
-// TODO[lab5c]: Add code that you don't want to use externally in namespace detail
+/**
+ * @brief bounded lock-free multi producer multi consumer ring, each slot has a turn number,
+ * even turn means the slot is empty for the producer of this round, odd turn means the slot
+ * is filled for the consumer of this round, so any capacity is supported
+ *
+ * @tparam T
+ * @tparam capacity
+ */
+template<typename T, size_t capacity>
+class channel_ring
+{
+    static_assert(capacity > 0, "channel capacity must be greater than 0");
+
+    struct slot
+    {
+        std::atomic<size_t> turn{0};
+        alignas(T) std::byte storage[sizeof(T)];
+
+        inline auto data() noexcept -> T* { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+public:
+    channel_ring() noexcept = default;
+
+    ~channel_ring() noexcept
+    {
+        std::optional<T> value;
+        while (try_pop(value)) {}
+    }
+
+    channel_ring(const channel_ring&)                    = delete;
+    auto operator=(const channel_ring&) -> channel_ring& = delete;
+
+    /**
+     * @brief push value if ring isn't full, value is moved only when push successfully
+     *
+     * @param value
+     * @return true if push successfully
+     */
+    template<typename value_type>
+    auto try_push(value_type&& value) noexcept -> bool
+    {
+        auto head = m_head.load(std::memory_order_acquire);
+        while (true)
+        {
+            auto& s = m_slots[head % capacity];
+            if (s.turn.load(std::memory_order_acquire) == turn(head) * 2)
+            {
+                if (m_head.compare_exchange_strong(head, head + 1, std::memory_order_acq_rel))
+                {
+                    new (s.storage) T(std::forward<value_type>(value));
+                    s.turn.store(turn(head) * 2 + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else
+            {
+                // slot is still occupied by the last round, ring is full if head doesn't move
+                auto prev = head;
+                head      = m_head.load(std::memory_order_acquire);
+                if (head == prev)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief pop value into out if ring isn't empty
+     *
+     * @param out
+     * @return true if pop successfully
+     */
+    auto try_pop(std::optional<T>& out) noexcept -> bool
+    {
+        auto tail = m_tail.load(std::memory_order_acquire);
+        while (true)
+        {
+            auto& s = m_slots[tail % capacity];
+            if (s.turn.load(std::memory_order_acquire) == turn(tail) * 2 + 1)
+            {
+                if (m_tail.compare_exchange_strong(tail, tail + 1, std::memory_order_acq_rel))
+                {
+                    out.emplace(std::move(*s.data()));
+                    s.data()->~T();
+                    s.turn.store(turn(tail) * 2 + 2, std::memory_order_release);
+                    return true;
+                }
+            }
+            else
+            {
+                auto prev = tail;
+                tail      = m_tail.load(std::memory_order_acquire);
+                if (tail == prev)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr auto turn(size_t pos) noexcept -> size_t { return pos / capacity; }
+
+private:
+    alignas(config::kCacheLineSize) std::atomic<size_t> m_head{0};
+    alignas(config::kCacheLineSize) std::atomic<size_t> m_tail{0};
+    std::array<slot, capacity> m_slots;
+};
+
+/**
+ * @brief intrusive fifo list of parked channel awaiters, protected by channel's spinlock
+ *
+ * @tparam waiter_type must have member m_next
+ */
+template<typename waiter_type>
+struct channel_waiter_list
+{
+    waiter_type* head{nullptr};
+    waiter_type* tail{nullptr};
+
+    inline auto empty() const noexcept -> bool { return head == nullptr; }
+
+    inline auto push_back(waiter_type* waiter) noexcept -> void
+    {
+        waiter->m_next = nullptr;
+        if (tail == nullptr)
+        {
+            head = tail = waiter;
+        }
+        else
+        {
+            tail->m_next = waiter;
+            tail         = waiter;
+        }
+    }
+
+    inline auto pop_front() noexcept -> waiter_type*
+    {
+        auto waiter = head;
+        head        = waiter->m_next;
+        if (head == nullptr)
+        {
+            tail = nullptr;
+        }
+        return waiter;
+    }
+
+    // remove waiter from list, return false if waiter isn't in list
+    inline auto remove(waiter_type* waiter) noexcept -> bool
+    {
+        waiter_type* prev = nullptr;
+        for (auto cur = head; cur != nullptr; prev = cur, cur = cur->m_next)
+        {
+            if (cur != waiter)
+            {
+                continue;
+            }
+            (prev == nullptr ? head : prev->m_next) = cur->m_next;
+            if (tail == cur)
+            {
+                tail = prev;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // take all waiters away and return the head
+    inline auto take_all() noexcept -> waiter_type*
+    {
+        auto waiter = head;
+        head = tail = nullptr;
+        return waiter;
+    }
+};
 }; // namespace detail
 
-// TODO[lab5c]: This channel is an example to make complie success,
-// You should delete it and add your implementation, I don't care what you do,
-// but keep the member function and construct function's declaration same with example.
+/**
+ * @brief bounded mpmc channel, when the buffer is neither full nor empty, send and recv complete
+ * by the lock-free ring without suspending, awaiters are parked only when the buffer is full or empty,
+ * and the counterpart moves data for the parked awaiter and then resumes it
+ *
+ * @note each data movement wakes at most one receiver and one sender, a woken awaiter continues
+ * serving the other parked awaiters when it resumes, so a batch costs one wakeup of the counterpart
+ *
+ * @tparam T
+ * @tparam capacity
+ */
 template<concepts::conventional_type T, size_t capacity = 1>
 class channel
 {
     using data_type = std::optional<T>;
 
 public:
+    /**
+     * @brief common part of send awaiters, values in [m_begin, m_end) are waiting to be sent
+     *
+     */
+    struct send_awaiter_base
+    {
+        send_awaiter_base(channel& ch, T* begin, T* end) noexcept : m_ch(ch), m_begin(begin), m_end(end) {}
+
+        send_awaiter_base(const send_awaiter_base&)                    = delete;
+        auto operator=(const send_awaiter_base&) -> send_awaiter_base& = delete;
+
+        auto await_ready() noexcept -> bool
+        {
+            if (m_ch.is_closed())
+            {
+                return true;
+            }
+            bool done = push_values();
+            if (m_sent > 0)
+            {
+                m_ch.serve_waiters();
+            }
+            return done;
+        }
+
+        auto await_suspend(std::coroutine_handle<> handle) noexcept -> bool
+        {
+            m_handle = handle;
+            m_ctx    = &local_context();
+
+            m_ch.m_lock.lock();
+            // 先发布等待者数量再重试，与 recv 方 "先取出数据再检查等待者数量" 配合，避免丢失唤醒
+            m_ch.m_num_send_waiters.fetch_add(1, std::memory_order_seq_cst);
+            auto sent = m_sent;
+            if (m_ch.is_closed() || push_values())
+            {
+                m_ch.m_num_send_waiters.fetch_sub(1, std::memory_order_relaxed);
+                m_ch.m_lock.unlock();
+                if (m_sent > sent)
+                {
+                    m_ch.serve_waiters();
+                }
+                return false;
+            }
+            // 解锁后本 awaiter 可能已被其他线程恢复并销毁，不能再访问成员
+            auto& ch     = m_ch;
+            bool  pushed = m_sent > sent;
+            m_parked     = true;
+            m_ctx->register_wait();
+            ch.m_send_waiters.push_back(this);
+            ch.m_lock.unlock();
+            if (pushed)
+            {
+                ch.serve_waiters();
+            }
+            return true;
+        }
+
+        // push values as many as possible, return true if all values are pushed
+        inline auto push_values() noexcept -> bool
+        {
+            while (m_begin != m_end && m_ch.m_ring.try_push(std::move(*m_begin)))
+            {
+                ++m_begin;
+                ++m_sent;
+            }
+            return m_begin == m_end;
+        }
+
+        inline auto resume_impl() noexcept -> size_t
+        {
+            if (m_parked)
+            {
+                m_ctx->unregister_wait();
+                m_ch.serve_waiters();
+            }
+            return m_sent;
+        }
+
+        inline auto resume() noexcept -> void { m_ctx->submit_task(m_handle); }
+
+        channel&                m_ch;
+        T*                      m_begin;
+        T*                      m_end;
+        size_t                  m_sent{0};
+        bool                    m_parked{false};
+        context*                m_ctx{nullptr};
+        std::coroutine_handle<> m_handle{nullptr};
+        send_awaiter_base*      m_next{nullptr};
+    };
+
+    struct send_awaiter : public send_awaiter_base
+    {
+        template<typename value_type>
+        send_awaiter(channel& ch, value_type&& value) noexcept
+            : send_awaiter_base(ch, &m_value, &m_value + 1),
+              m_value(std::forward<value_type>(value))
+        {
+        }
+
+        auto await_resume() noexcept -> bool { return this->resume_impl() == 1; }
+
+        T m_value;
+    };
+
+    struct send_batch_awaiter : public send_awaiter_base
+    {
+        send_batch_awaiter(channel& ch, std::span<T> values) noexcept
+            : send_awaiter_base(ch, values.data(), values.data() + values.size())
+        {
+        }
+
+        auto await_resume() noexcept -> size_t { return this->resume_impl(); }
+    };
+
+    /**
+     * @brief common part of recv awaiters, m_pop moves data from ring to the derived awaiter
+     *
+     */
+    struct recv_awaiter_base
+    {
+        // return true if at least one value is popped
+        using pop_type = bool (*)(recv_awaiter_base*) noexcept;
+
+        recv_awaiter_base(channel& ch, pop_type pop) noexcept : m_ch(ch), m_pop(pop) {}
+
+        recv_awaiter_base(const recv_awaiter_base&)                    = delete;
+        auto operator=(const recv_awaiter_base&) -> recv_awaiter_base& = delete;
+
+        auto await_ready() noexcept -> bool
+        {
+            // 先读关闭标志再取数据，保证关闭前发送的数据都能被取到
+            bool closed = m_ch.is_closed();
+            if (m_pop(this))
+            {
+                m_ch.serve_waiters();
+                return true;
+            }
+            return closed;
+        }
+
+        auto await_suspend(std::coroutine_handle<> handle) noexcept -> bool
+        {
+            m_handle = handle;
+            m_ctx    = &local_context();
+
+            m_ch.m_lock.lock();
+            m_ch.m_num_recv_waiters.fetch_add(1, std::memory_order_seq_cst);
+            bool closed = m_ch.is_closed();
+            bool popped = m_pop(this);
+            if (popped || closed)
+            {
+                m_ch.m_num_recv_waiters.fetch_sub(1, std::memory_order_relaxed);
+                m_ch.m_lock.unlock();
+                if (popped)
+                {
+                    m_ch.serve_waiters();
+                }
+                return false;
+            }
+            m_parked = true;
+            m_ctx->register_wait();
+            m_ch.m_recv_waiters.push_back(this);
+            m_ch.m_lock.unlock();
+            return true;
+        }
+
+        inline auto resume_impl() noexcept -> void
+        {
+            if (m_parked)
+            {
+                m_ctx->unregister_wait();
+                m_ch.serve_waiters();
+            }
+        }
+
+        inline auto resume() noexcept -> void
+        {
+            if (m_select == nullptr)
+            {
+                m_ctx->submit_task(m_handle);
+                return;
+            }
+            // select 节点由赢家负责恢复 select 所在协程
+            auto state = m_select;
+            if (state->complete())
+            {
+                state->resume();
+            }
+        }
+
+        // select node whose select has been won by another source
+        inline auto is_cancelled() const noexcept -> bool { return m_select != nullptr && m_select->is_won(); }
+
+        channel&                m_ch;
+        pop_type                m_pop;
+        bool                    m_parked{false};
+        context*                m_ctx{nullptr};
+        std::coroutine_handle<> m_handle{nullptr};
+        recv_awaiter_base*      m_next{nullptr};
+        detail::select_state*   m_select{nullptr};
+        int                     m_index{0};
+    };
+
+    struct select_recv_node;
+
+    struct recv_awaiter : public recv_awaiter_base
+    {
+        using select_node_type = select_recv_node;
+
+        explicit recv_awaiter(channel& ch) noexcept : recv_awaiter_base(ch, &recv_awaiter::pop) {}
+
+        auto await_resume() noexcept -> data_type
+        {
+            this->resume_impl();
+            return std::move(m_data);
+        }
+
+        static auto pop(recv_awaiter_base* base) noexcept -> bool
+        {
+            auto awaiter = static_cast<recv_awaiter*>(base);
+            return awaiter->m_ch.m_ring.try_pop(awaiter->m_data);
+        }
+
+        data_type m_data;
+    };
+
+    struct recv_batch_awaiter : public recv_awaiter_base
+    {
+        // m_data is reserved here so that pop never allocates memory under channel's lock
+        recv_batch_awaiter(channel& ch, size_t max_n)
+            : recv_awaiter_base(ch, &recv_batch_awaiter::pop),
+              m_max(std::min(max_n, capacity))
+        {
+            assert(max_n > 0 && "recv_batch needs max_n greater than 0");
+            m_data.reserve(m_max);
+        }
+
+        auto await_resume() noexcept -> std::vector<T>
+        {
+            this->resume_impl();
+            return std::move(m_data);
+        }
+
+        static auto pop(recv_awaiter_base* base) noexcept -> bool
+        {
+            auto      awaiter = static_cast<recv_batch_awaiter*>(base);
+            data_type value;
+            // m_max never exceeds the reserved capacity, push_back doesn't reallocate
+            while (awaiter->m_data.size() < awaiter->m_max && awaiter->m_ch.m_ring.try_pop(value))
+            {
+                awaiter->m_data.push_back(std::move(*value));
+            }
+            return !awaiter->m_data.empty();
+        }
+
+        size_t         m_max;
+        std::vector<T> m_data;
+    };
+
+    /**
+     * @brief recv node of coro::select, data is popped for it only after the select is claimed
+     *
+     */
+    struct select_recv_node : public recv_awaiter_base
+    {
+        using result_type = data_type;
+
+        explicit select_recv_node(const recv_awaiter& awaiter) noexcept
+            : recv_awaiter_base(awaiter.m_ch, &select_recv_node::pop)
+        {
+        }
+
+        // register to channel, return false if the select is finished during registering
+        auto select_register(detail::select_state& state, int index) noexcept -> bool
+        {
+            this->m_select = &state;
+            this->m_index  = index;
+
+            auto& ch = this->m_ch;
+            ch.m_lock.lock();
+            ch.m_num_recv_waiters.fetch_add(1, std::memory_order_seq_cst);
+            bool closed = ch.is_closed();
+            bool popped = pop(this);
+            if (!popped && !closed && !this->is_cancelled())
+            {
+                this->m_parked = true;
+                ch.m_recv_waiters.push_back(this);
+                ch.m_lock.unlock();
+                return true;
+            }
+            ch.m_num_recv_waiters.fetch_sub(1, std::memory_order_relaxed);
+            ch.m_lock.unlock();
+
+            if (popped)
+            {
+                ch.serve_waiters();
+            }
+            else if (closed)
+            {
+                // 已关闭的 channel 以 std::nullopt 参与竞争
+                state.try_win(index);
+            }
+            return false;
+        }
+
+        // remove from channel if the node is still parked
+        auto select_cancel() noexcept -> void
+        {
+            if (!this->m_parked || this->m_select->winner() == this->m_index)
+            {
+                return;
+            }
+            auto& ch = this->m_ch;
+            ch.m_lock.lock();
+            if (ch.m_recv_waiters.remove(this))
+            {
+                ch.m_num_recv_waiters.fetch_sub(1, std::memory_order_relaxed);
+            }
+            ch.m_lock.unlock();
+        }
+
+        auto select_result() noexcept -> result_type { return std::move(m_data); }
+
+        static auto pop(recv_awaiter_base* base) noexcept -> bool
+        {
+            auto node = static_cast<select_recv_node*>(base);
+            if (!node->m_select->try_claim())
+            {
+                return false;
+            }
+            if (node->m_ch.m_ring.try_pop(node->m_data))
+            {
+                node->m_select->confirm(node->m_index);
+                return true;
+            }
+            node->m_select->abort();
+            return false;
+        }
+
+        data_type m_data;
+    };
+
+public:
+    channel() noexcept = default;
+    ~channel() noexcept
+    {
+        assert(m_send_waiters.empty() && m_recv_waiters.empty() && "channel is destroyed with waiters");
+    }
+
+    channel(const channel&)                    = delete;
+    channel(channel&&)                         = delete;
+    auto operator=(const channel&) -> channel& = delete;
+    auto operator=(channel&&) -> channel&      = delete;
+
+    /**
+     * @brief send value to channel, suspend if channel is full, the awaiter is returned directly
+     * so sending doesn't allocate coroutine frame
+     *
+     * @param value
+     * @return send_awaiter, co_await it returns false if channel has been closed
+     */
+    template<typename value_type>
+        requires(std::is_constructible_v<T, value_type &&>)
+    auto send(value_type&& value) noexcept -> send_awaiter
+    {
+        return send_awaiter(*this, std::forward<value_type>(value));
+    }
+
+    /**
+     * @brief recv value from channel, suspend if channel is empty
+     *
+     * @return recv_awaiter, co_await it returns std::nullopt if channel has been closed and is empty
+     */
+    auto recv() noexcept -> recv_awaiter { return recv_awaiter(*this); }
+
+    /**
+     * @brief move all values into channel, suspend until all values are sent or channel is closed,
+     * values are pushed in one pass and at most one parked receiver is woken for them
+     *
+     * @param values must be alive until co_await returns
+     * @return send_batch_awaiter, co_await it returns the number of sent values
+     */
+    auto send_batch(std::span<T> values) noexcept -> send_batch_awaiter { return send_batch_awaiter(*this, values); }
+
+    /**
+     * @brief recv at most max_n values from channel, suspend only if channel is empty,
+     * max_n larger than capacity is clamped to capacity
+     *
+     * @param max_n
+     * @return recv_batch_awaiter, co_await it returns the values received, empty vector means
+     * channel has been closed and is empty
+     * @throw std::bad_alloc if the result vector can't be reserved
+     */
+    auto recv_batch(size_t max_n) -> recv_batch_awaiter { return recv_batch_awaiter(*this, max_n); }
+
+    /**
+     * @brief send value without suspending
+     *
+     * @param value
+     * @return true if value is sent, false if channel is full or closed
+     */
     template<typename value_type>
         requires(std::is_constructible_v<T, value_type &&>)
-    auto send(value_type&& value) noexcept -> task<bool>
+    auto try_send(value_type&& value) noexcept -> bool
+    {
+        if (is_closed() || !m_ring.try_push(std::forward<value_type>(value)))
+        {
+            return false;
+        }
+        serve_waiters();
+        return true;
+    }
+
+    /**
+     * @brief recv value without suspending
+     *
+     * @return data_type, std::nullopt if channel is empty
+     */
+    auto try_recv() noexcept -> data_type
+    {
+        data_type data;
+        if (m_ring.try_pop(data))
+        {
+            serve_waiters();
+        }
+        return data;
+    }
+
+    /**
+     * @brief close channel, all parked senders return false, all parked receivers return
+     * std::nullopt, value in buffer can still be received
+     *
+     */
+    auto close() noexcept -> void
     {
-        co_return {};
+        m_closed.store(true, std::memory_order_seq_cst);
+
+        m_lock.lock();
+        auto sender   = m_send_waiters.take_all();
+        auto receiver = m_recv_waiters.take_all();
+        m_num_send_waiters.store(0, std::memory_order_relaxed);
+        m_num_recv_waiters.store(0, std::memory_order_relaxed);
+        // select 接收者在锁内竞争，失败者解锁后可能随时被释放，直接丢弃
+        detail::channel_waiter_list<recv_awaiter_base> receivers;
+        while (receiver != nullptr)
+        {
+            auto next = receiver->m_next;
+            if (receiver->m_select == nullptr || receiver->m_select->try_win(receiver->m_index))
+            {
+                receivers.push_back(receiver);
+            }
+            receiver = next;
+        }
+        receiver = receivers.take_all();
+        m_lock.unlock();
+
+        while (sender != nullptr)
+        {
+            auto next = sender->m_next;
+            sender->resume();
+            sender = next;
+        }
+        while (receiver != nullptr)
+        {
+            auto next = receiver->m_next;
+            receiver->resume();
+            receiver = next;
+        }
+    }
+
+    inline auto is_closed() const noexcept -> bool { return m_closed.load(std::memory_order_acquire); }
+
+private:
+    /**
+     * @brief after pushing or popping data, move data for the earliest parked receiver and sender,
+     * the woken awaiter calls this again when it resumes to pass the wakeup on
+     *
+     */
+    auto serve_waiters() noexcept -> void
+    {
+        serve_receiver();
+        // 批量发送者只被部分满足时不会被唤醒，由当前线程继续为接收者服务
+        if (serve_sender())
+        {
+            serve_receiver();
+        }
+    }
+
+    // pop data for the earliest parked receiver and resume it
+    auto serve_receiver() noexcept -> void
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_num_recv_waiters.load(std::memory_order_relaxed) == 0)
+        {
+            return;
+        }
+
+        m_lock.lock();
+        while (!m_recv_waiters.empty())
+        {
+            auto waiter = m_recv_waiters.head;
+            if (waiter->m_pop(waiter))
+            {
+                m_recv_waiters.pop_front();
+                m_num_recv_waiters.fetch_sub(1, std::memory_order_relaxed);
+                m_lock.unlock();
+
+                waiter->resume();
+                return;
+            }
+            if (!waiter->is_cancelled())
+            {
+                break;
+            }
+            // select 已被其他来源赢得，丢弃该节点
+            m_recv_waiters.pop_front();
+            m_num_recv_waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+        m_lock.unlock();
+    }
+
+    // push data for the earliest parked sender, resume it if all its values are pushed,
+    // return true if values are pushed but the sender is still parked
+    auto serve_sender() noexcept -> bool
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_num_send_waiters.load(std::memory_order_relaxed) == 0)
+        {
+            return false;
+        }
+
+        m_lock.lock();
+        if (m_send_waiters.empty())
+        {
+            m_lock.unlock();
+            return false;
+        }
+        auto waiter = m_send_waiters.head;
+        auto sent   = waiter->m_sent;
+        if (!waiter->push_values())
+        {
+            m_lock.unlock();
+            return waiter->m_sent > sent;
+        }
+        m_send_waiters.pop_front();
+        m_num_send_waiters.fetch_sub(1, std::memory_order_relaxed);
+        m_lock.unlock();
+
+        waiter->resume();
+        return false;
     }
 
-    auto recv() noexcept -> task<data_type> { co_return {}; }
+private:
+    detail::channel_ring<T, capacity> m_ring;
+    std::atomic<bool>                 m_closed{false};
 
-    auto close() noexcept -> void {}
+    // slow path, parked awaiters are protected by m_lock
+    detail::spinlock                                    m_lock;
+    detail::channel_waiter_list<send_awaiter_base>      m_send_waiters;
+    detail::channel_waiter_list<recv_awaiter_base>      m_recv_waiters;
+    alignas(config::kCacheLineSize) std::atomic<size_t> m_num_send_waiters{0};
+    alignas(config::kCacheLineSize) std::atomic<size_t> m_num_recv_waiters{0};
 };
 
 }; // namespace coro
@@ -10,6 +10,8 @@
  */
 #pragma once
 
+#include <atomic>
+#include <coroutine>
 #include <functional>
 
 #include "coro/attribute.hpp"
@@ -39,26 +41,76 @@ using cond_type = std::function<bool()>;
 class condition_variable;
 using cond_var = condition_variable;
 
-// TODO[lab5b]: This condition_variable is an example to make complie success,
-// You should delete it and add your implementation, I don't care what you do,
-// but keep the member function and construct function's declaration same with example.
+/**
+ * @brief coroutine condition variable, waiters are pushed to an intrusive lock-free list,
+ * notify moves waiters to the mutex directly instead of resuming them (wait morphing), each
+ * waiter is resumed only after it gets the mutex and its condition is true, so notify_all
+ * never wakes a herd of coroutines which just block on the mutex again
+ *
+ */
 class condition_variable final
 {
 public:
+    struct [[CORO_AWAIT_HINT]] cv_awaiter : public mutex::mutex_awaiter
+    {
+        cv_awaiter(context& ctx, mutex& mtx, condition_variable& cv) noexcept;
+
+        cv_awaiter(context& ctx, mutex& mtx, condition_variable& cv, cond_type& cond) noexcept;
+
+        cv_awaiter(context& ctx, mutex& mtx, condition_variable& cv, cond_type&& cond) noexcept;
+
+        auto await_ready() noexcept -> bool;
+
+        auto await_suspend(std::coroutine_handle<> handle) noexcept -> bool;
+
+        // the mutex has been handed to the awaiter, return false and wait again if cond is false
+        static auto on_locked(mutex::mutex_awaiter* waiter) noexcept -> bool;
+
+        inline auto has_cond() const noexcept -> bool { return m_cond_ref != nullptr || bool(m_cond); }
+
+        inline auto check_cond() -> bool { return m_cond_ref != nullptr ? (*m_cond_ref)() : m_cond(); }
+
+        condition_variable& m_cv;
+        cond_type*          m_cond_ref{nullptr};
+        cond_type           m_cond;
+    };
+
     condition_variable() noexcept  = default;
     ~condition_variable() noexcept = default;
 
     CORO_NO_COPY_MOVE(condition_variable);
 
-    auto wait(mutex& mtx) noexcept -> detail::noop_awaiter { return {}; }
+    /**
+     * @brief release mtx and wait for notify, mtx is held again when co_await returns
+     *
+     * @param mtx must be held by the caller
+     */
+    auto wait(mutex& mtx) noexcept -> cv_awaiter;
+
+    // wait until cond returns true, cond is checked with mtx held
+    auto wait(mutex& mtx, cond_type&& cond) noexcept -> cv_awaiter;
+
+    auto wait(mutex& mtx, cond_type& cond) noexcept -> cv_awaiter;
+
+    // move the earliest waiter to its mutex
+    auto notify_one() noexcept -> void;
 
-    auto wait(mutex& mtx, cond_type&& cond) noexcept -> detail::noop_awaiter { return {}; }
+    // detach all waiters and move them to their mutex in FIFO order
+    auto notify_all() noexcept -> void;
 
-    auto wait(mutex& mtx, cond_type& cond) noexcept -> detail::noop_awaiter { return {}; }
+private:
+    auto push_waiter(cv_awaiter* waiter) noexcept -> void;
 
-    auto notify_one() noexcept -> void {};
+    // move waiters from m_state to the FIFO list, m_lock must be held
+    auto take_waiters() noexcept -> void;
 
-    auto notify_all() noexcept -> void {};
+private:
+    // newest waiter, waiters are pushed by cas without lock
+    std::atomic<cv_awaiter*> m_state{nullptr};
+    // pop side is serialized by m_lock, waiters in FIFO order
+    detail::spinlock m_lock;
+    cv_awaiter*      m_head{nullptr};
+    cv_awaiter*      m_tail{nullptr};
 };
 
 }; // namespace coro
@@ -11,12 +11,16 @@
 #pragma once
 #include <atomic>
 #include <coroutine>
+#include <type_traits>
+#include <variant>
 
 #include "coro/attribute.hpp"
 #include "coro/concepts/awaitable.hpp"
 #include "coro/context.hpp"
 #include "coro/detail/container.hpp"
+#include "coro/detail/select_state.hpp"
 #include "coro/detail/types.hpp"
+#include "coro/spinlock.hpp"
 
 namespace coro
 {
@@ -46,6 +50,9 @@ class event_base
 public:
     struct awaiter_base
     {
+        // 非空时 set 调用该函数代替直接恢复协程
+        using resume_type = void (*)(awaiter_base*) noexcept;
+
         awaiter_base(context& ctx, event_base& e) noexcept : m_ctx(ctx), m_ev(e) {}
 
         inline auto next() noexcept -> awaiter_base* { return m_next; }
@@ -60,6 +67,30 @@ public:
         event_base&             m_ev;                  // 绑定的 event
         awaiter_base*           m_next{nullptr};       // 链表的 next 指针
         std::coroutine_handle<> m_await_coro{nullptr}; // 待 resume 的协程句柄
+        resume_type             m_resume{nullptr};     // 自定义恢复函数
+    };
+
+    /**
+     * @brief event node of coro::select, it claims the select when event is set instead of
+     * resuming the coroutine directly, and can be removed from event if the select is won by
+     * another source
+     */
+    struct select_node_base : public awaiter_base
+    {
+        select_node_base(event_base& e) noexcept : awaiter_base(local_context(), e) { m_resume = &on_set; }
+
+        // register to event, return false if the select is finished during registering
+        auto select_register(select_state& state, int index) noexcept -> bool;
+
+        // remove from event if the node isn't the winner
+        auto select_cancel() noexcept -> void;
+
+        static auto on_set(awaiter_base* waiter) noexcept -> void;
+
+        select_state*     m_select{nullptr};
+        int               m_index{0};
+        bool              m_parked{false};
+        std::atomic<bool> m_done{false}; // set has finished visiting this node
     };
 
     event_base(bool initial_set = false) noexcept : m_state((initial_set) ? this : nullptr) {}
@@ -75,13 +106,30 @@ public:
 
     auto set_state() noexcept -> void; // 设置 event，唤醒所有 suspend awaiter
 
-    auto resume_all_awaiter(awaiter_ptr waiter) noexcept -> void; // 唤醒所有 suspend awaiter
+    // 清除 set 状态，之后的 awaiter 会被挂起，未被 set 时不做任何事
+    inline auto reset_state() noexcept -> void
+    {
+        awaiter_ptr expected = this;
+        m_state.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+    }
+
+    auto resume_all_awaiter(awaiter_ptr waiter) noexcept -> void; // 唤醒所有 suspend awaiter，按 context 批量提交
 
     auto register_awaiter(awaiter_base* waiter) noexcept -> bool; // 挂载 suspend awaiter
 
+    /**
+     * @brief remove a suspended awaiter from event
+     *
+     * @param waiter
+     * @return false if event has been set and the awaiter has been taken away by set
+     */
+    auto unregister_awaiter(awaiter_base* waiter) noexcept -> bool;
+
 private:
     // 链表头
     std::atomic<awaiter_ptr> m_state{nullptr};
+    // 串行化 unregister_awaiter，set 与 register 不需要获取该锁
+    spinlock m_cancel_lock;
 };
 
 }; // namespace detail
@@ -94,8 +142,12 @@ class event : public detail::event_base, public detail::container<return_type>
 {
 public:
     // Just make compile success
+    struct select_node;
+
     struct [[CORO_AWAIT_HINT]] awaiter : public detail::event_base::awaiter_base
     {
+        using select_node_type = select_node;
+
         using awaiter_base::awaiter_base;
         auto await_resume() noexcept -> decltype(auto) // 重新定义基类的同名函数
         {
@@ -104,6 +156,15 @@ public:
         }
     };
 
+    struct select_node : public detail::event_base::select_node_base
+    {
+        using result_type = std::remove_cvref_t<decltype(std::declval<event&>().result())>;
+
+        explicit select_node(const awaiter& waiter) noexcept : select_node_base(waiter.m_ev) {}
+
+        auto select_result() noexcept -> result_type { return static_cast<event&>(m_ev).result(); }
+    };
+
     [[CORO_AWAIT_HINT]] awaiter wait() noexcept { return awaiter(local_context(), *this); }
 
     template<typename value_type>
@@ -118,13 +179,26 @@ template<>
 class event<void> : public detail::event_base
 {
 public:
+    struct select_node;
+
     struct [[CORO_AWAIT_HINT]] awaiter : public detail::event_base::awaiter_base
     {
+        using select_node_type = select_node;
+
         // 将基类 awaiter_base 的构造函数引入派生类 awaiter
         // 的作用域，使得派生类可以直接复用基类的构造函数，无需重新定义。
         using awaiter_base::awaiter_base;
     };
 
+    struct select_node : public detail::event_base::select_node_base
+    {
+        using result_type = std::monostate;
+
+        explicit select_node(const awaiter& waiter) noexcept : select_node_base(waiter.m_ev) {}
+
+        auto select_result() noexcept -> result_type { return {}; }
+    };
+
     [[CORO_AWAIT_HINT]] awaiter wait() noexcept { return awaiter(local_context(), *this); }
 
     auto set() noexcept -> void { set_state(); }
@@ -12,7 +12,9 @@
 
 #include <atomic>
 
-#include "coro/detail/types.hpp"
+#include "coro/attribute.hpp"
+#include "coro/comp/event.hpp"
+#include "coro/context.hpp"
 
 namespace coro
 {
@@ -32,21 +34,32 @@ namespace coro
  * and then, enjoy yourself!
  */
 
-// TODO[lab4b]: This latch is an example to make complie success,
-// You should delete it and add your implementation, I don't care what you do,
-// but keep the function count_down() and wait()'s declaration same with example.
+/**
+ * @brief coroutine latch, count_down() costs one atomic operation, the call which drops the
+ * counter to zero sets the embedded event and resumes all waiters, a latch can't be reused
+ *
+ */
 class latch
 {
 public:
-    latch(std::uint64_t count) noexcept {}
+    struct [[CORO_AWAIT_HINT]] awaiter : public detail::event_base::awaiter_base
+    {
+        using awaiter_base::awaiter_base;
+    };
+
+    latch(std::uint64_t count) noexcept : m_count(count), m_ev(count == 0) {}
     latch(const latch&)                    = delete;
     latch(latch&&)                         = delete;
     auto operator=(const latch&) -> latch& = delete;
     auto operator=(latch&&) -> latch&      = delete;
 
-    auto count_down() noexcept -> void {}
+    auto count_down() noexcept -> void;
+
+    [[CORO_AWAIT_HINT]] auto wait() noexcept -> awaiter { return awaiter(local_context(), m_ev); }
 
-    auto wait() noexcept -> detail::noop_awaiter { return {}; }
+private:
+    std::atomic<std::uint64_t> m_count;
+    detail::event_base         m_ev;
 };
 
 /**
@@ -38,30 +38,92 @@ namespace coro
 
 class context;
 
-// TODO[lab4d]: This mutex is an example to make complie success,
-// You should delete it and add your implementation, I don't care what you do,
-// but keep the member function and construct function's declaration same with example.
+/**
+ * @brief coroutine mutex, m_state is an atomic word which doubles as an intrusive waiter list,
+ * unlock hands the ownership to the earliest waiter directly and resumes it in its own context,
+ * so the waiter never needs to compete for the mutex again after wakeup
+ *
+ * @note m_state: unlocked_state means unlocked, nullptr means locked without waiters,
+ * other values mean locked and point to the newest waiter
+ */
 class mutex
 {
-    // Just make lock_guard() compile success
-    struct guard_awaiter : detail::noop_awaiter
+public:
+    struct mutex_awaiter
+    {
+        // 非空时锁转交给该 awaiter 后调用该函数代替直接恢复协程，返回 false 表示不接受锁
+        using resume_type = auto (*)(mutex_awaiter*) noexcept -> bool;
+
+        mutex_awaiter(context& ctx, mutex& mtx) noexcept : m_ctx(ctx), m_mtx(mtx) {}
+
+        auto await_ready() noexcept -> bool;
+
+        auto await_suspend(std::coroutine_handle<> handle) noexcept -> bool;
+
+        auto await_resume() noexcept -> void;
+
+        // try to fetch lock, if the mutex is locked, push this awaiter into waiter list
+        auto register_lock() noexcept -> bool;
+
+        /**
+         * @brief the lock has been handed to this awaiter, resume it in its own context
+         *
+         * @return false if the awaiter refuses the lock, the caller must release the lock then
+         */
+        auto resume() noexcept -> bool;
+
+        context&                m_ctx;
+        mutex&                  m_mtx;
+        mutex_awaiter*          m_next{nullptr};
+        std::coroutine_handle<> m_await_coro{nullptr};
+        resume_type             m_resume{nullptr};
+    };
+
+    struct mutex_guard_awaiter : public mutex_awaiter
     {
-        guard_awaiter(mutex& m) noexcept : mtx(m) {}
-        auto   await_resume() -> detail::lock_guard<mutex> { return detail::lock_guard<mutex>(mtx); }
-        mutex& mtx;
+        using mutex_awaiter::mutex_awaiter;
+
+        auto await_resume() noexcept -> detail::lock_guard<mutex>
+        {
+            mutex_awaiter::await_resume();
+            return detail::lock_guard<mutex>(m_mtx);
+        }
     };
 
 public:
-    mutex() noexcept {}
-    ~mutex() noexcept {}
+    mutex() noexcept : m_state(unlocked_state()), m_resume_list_head(nullptr) {}
+    ~mutex() noexcept { assert(m_state.load(std::memory_order_acquire) == unlocked_state()); }
+
+    mutex(const mutex&)                    = delete;
+    mutex(mutex&&)                         = delete;
+    auto operator=(const mutex&) -> mutex& = delete;
+    auto operator=(mutex&&) -> mutex&      = delete;
+
+    auto try_lock() noexcept -> bool;
+
+    auto lock() noexcept -> mutex_awaiter;
+
+    auto unlock() noexcept -> void;
+
+    auto lock_guard() noexcept -> mutex_guard_awaiter;
 
-    auto try_lock() noexcept -> bool { return {}; }
+    /**
+     * @brief push waiters first ... last to the mutex at once, they get the lock in this order,
+     * if the mutex is unlocked, first gets the lock immediately and is resumed by this call
+     *
+     * @param first the earliest waiter, waiters are linked by m_next
+     * @param last the latest waiter
+     */
+    auto lock_chain(mutex_awaiter* first, mutex_awaiter* last) noexcept -> void;
 
-    auto lock() noexcept -> detail::noop_awaiter { return {}; };
+private:
+    inline auto unlocked_state() noexcept -> detail::awaiter_ptr { return this; }
 
-    auto unlock() noexcept -> void {};
+private:
+    std::atomic<detail::awaiter_ptr> m_state;
 
-    auto lock_guard() noexcept -> guard_awaiter { return {*this}; };
+    // waiters taken from m_state in FIFO order, only accessed by the lock holder
+    mutex_awaiter* m_resume_list_head;
 };
 
 }; // namespace coro
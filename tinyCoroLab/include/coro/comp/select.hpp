@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "coro/attribute.hpp"
+#include "coro/comp/channel.hpp"
+#include "coro/comp/event.hpp"
+#include "coro/context.hpp"
+#include "coro/detail/select_state.hpp"
+
+namespace coro
+{
+namespace detail
+{
+/**
+ * @brief awaiter of coro::select, it registers one node on each source, the first source
+ * which becomes ready claims the select and resumes the coroutine, all the other nodes are
+ * removed from their sources when the coroutine resumes, so the losers never resume it
+ *
+ * @tparam node_types select node of each source, provides select_register, select_cancel
+ * and select_result
+ */
+template<typename... node_types>
+class select_awaiter
+{
+public:
+    using result_type = std::variant<typename node_types::result_type...>;
+
+    template<typename... awaiter_types>
+    explicit select_awaiter(awaiter_types&&... awaiters) noexcept : m_nodes(awaiters...)
+    {
+    }
+
+    select_awaiter(const select_awaiter&)                    = delete;
+    auto operator=(const select_awaiter&) -> select_awaiter& = delete;
+
+    auto await_ready() noexcept -> bool { return false; }
+
+    auto await_suspend(std::coroutine_handle<> handle) noexcept -> bool
+    {
+        m_state.m_ctx    = &local_context();
+        m_state.m_handle = handle;
+        m_state.m_ctx->register_wait();
+
+        register_nodes(std::index_sequence_for<node_types...>{});
+        // 注册期间已有来源获胜则不挂起
+        return !m_state.complete();
+    }
+
+    auto await_resume() noexcept -> result_type
+    {
+        m_state.m_ctx->unregister_wait();
+        std::apply([](auto&... nodes) { (nodes.select_cancel(), ...); }, m_nodes);
+        return make_result(std::index_sequence_for<node_types...>{});
+    }
+
+private:
+    template<size_t... index>
+    auto register_nodes(std::index_sequence<index...>) noexcept -> void
+    {
+        // 按顺序注册，某个来源在注册时就绪则停止注册后续来源
+        (register_node<index>() && ...);
+    }
+
+    // return true if the select is still waiting
+    template<size_t index>
+    auto register_node() noexcept -> bool
+    {
+        if (m_state.is_won())
+        {
+            return false;
+        }
+        if (std::get<index>(m_nodes).select_register(m_state, static_cast<int>(index)))
+        {
+            return true;
+        }
+        if (m_state.winner() == static_cast<int>(index))
+        {
+            // 注册线程自身成为赢家
+            m_state.complete();
+        }
+        return false;
+    }
+
+    template<size_t... index>
+    auto make_result(std::index_sequence<index...>) noexcept -> result_type
+    {
+        std::optional<result_type> result;
+        auto                       winner = static_cast<size_t>(m_state.winner());
+        ((winner == index ? (result.emplace(std::in_place_index<index>, std::get<index>(m_nodes).select_result()), 0)
+                          : 0),
+         ...);
+        return std::move(*result);
+    }
+
+private:
+    std::tuple<node_types...> m_nodes;
+    select_state              m_state;
+};
+
+}; // namespace detail
+
+/**
+ * @brief wait for whichever of channel::recv() and event::wait() becomes ready first,
+ * e.g. co_await select(ch.recv(), ev.wait()), only the winner consumes its source
+ *
+ * @param awaiters awaiters returned by channel::recv() or event::wait()
+ * @return awaiter, co_await it returns std::variant whose index() is the index of the winner,
+ * the alternative holds the result of the winner, event<void> yields std::monostate
+ */
+template<typename... awaiter_types>
+    requires(sizeof...(awaiter_types) > 0)
+[[CORO_AWAIT_HINT]] auto select(awaiter_types&&... awaiters) noexcept
+    -> detail::select_awaiter<typename std::remove_cvref_t<awaiter_types>::select_node_type...>
+{
+    return detail::select_awaiter<typename std::remove_cvref_t<awaiter_types>::select_node_type...>(
+        std::forward<awaiter_types>(awaiters)...);
+}
+
+}; // namespace coro
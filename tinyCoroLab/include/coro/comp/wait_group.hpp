@@ -13,7 +13,9 @@
 #include <atomic>
 #include <coroutine>
 
-#include "coro/detail/types.hpp"
+#include "coro/attribute.hpp"
+#include "coro/comp/event.hpp"
+#include "coro/context.hpp"
 
 namespace coro
 {
@@ -35,19 +37,41 @@ namespace coro
 
 class context;
 
-// TODO[lab4c]: This wait_group is an example to make complie success,
-// You should delete it and add your implementation, I don't care what you do,
-// but keep the member function and construct function's declaration same with example.
+/**
+ * @brief go style wait_group, add() and done() cost one atomic operation each, only the call
+ * which drops the counter to zero touches the waiter list and resumes all waiters on their own
+ * context, waiters are kept in an intrusive lock-free list the same as event
+ *
+ * @note like go, add() with positive count must happen before wait(), a wait_group can be reused
+ * after all previous wait() returned
+ */
 class wait_group
 {
 public:
-    explicit wait_group(int count = 0) noexcept {}
+    struct [[CORO_AWAIT_HINT]] awaiter : public detail::event_base::awaiter_base
+    {
+        using awaiter_base::awaiter_base;
+    };
+
+    explicit wait_group(int count = 0) noexcept : m_count(count), m_ev(count <= 0) {}
+
+    CORO_NO_COPY_MOVE(wait_group);
+
+    /**
+     * @brief add count to the counter, negative count is allowed, all waiters are resumed if
+     * the counter drops to zero
+     *
+     * @param count
+     */
+    auto add(int count) noexcept -> void;
 
-    auto add(int count) noexcept -> void {};
+    inline auto done() noexcept -> void { add(-1); }
 
-    auto done() noexcept -> void {};
+    [[CORO_AWAIT_HINT]] auto wait() noexcept -> awaiter { return awaiter(local_context(), m_ev); }
 
-    auto wait() noexcept -> detail::noop_awaiter { return {}; };
+private:
+    std::atomic<int32_t> m_count;
+    detail::event_base   m_ev;
 };
 
 }; // namespace coro
@@ -13,11 +13,17 @@
 #include <array>
 #include <ranges>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 #include "coro/attribute.hpp"
 #include "coro/comp/latch.hpp"
 #include "coro/concepts/awaitable.hpp"
+#include "coro/context.hpp"
+#include "coro/detail/types.hpp"
+#include "coro/detail/void_value.hpp"
+#include "coro/scheduler.hpp"
+#include "coro/task.hpp"
 
 namespace coro
 {
@@ -36,45 +42,320 @@ namespace coro
  * @note lab4 and lab5 are free designed lab, leave the interfaces that the test case will use,
  * and then, enjoy yourself!
  */
+using launch_policy = detail::launch_policy;
+
 namespace detail
 {
-// TODO[lab5a]: Add code that you don't want to use externally in namespace detail
-}; // namespace detail
+template<typename type>
+struct is_task : std::false_type
+{
+};
+
+template<typename return_type>
+struct is_task<task<return_type>> : std::true_type
+{
+    using result_type = return_type;
+};
+
+template<typename type>
+concept task_type = is_task<std::remove_cvref_t<type>>::value;
+
+template<concepts::awaitable awaitable_type>
+using when_all_return_t = typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type;
+
+// wrap awaitable which isn't task into task, this is the only case when_all allocates for child
+template<concepts::awaitable awaitable_type>
+auto make_when_all_task(awaitable_type awaitable) -> task<std::remove_cvref_t<when_all_return_t<awaitable_type>>>
+{
+    if constexpr (std::is_void_v<when_all_return_t<awaitable_type>>)
+    {
+        co_await awaitable;
+    }
+    else
+    {
+        co_return co_await awaitable;
+    }
+}
+
+template<concepts::awaitable awaitable_type>
+auto to_when_all_task(awaitable_type&& awaitable)
+{
+    if constexpr (task_type<awaitable_type>)
+    {
+        return std::move(awaitable);
+    }
+    else
+    {
+        return make_when_all_task(std::forward<awaitable_type>(awaitable));
+    }
+}
+
+template<typename return_type>
+using when_all_value_t = std::conditional_t<std::is_void_v<return_type>, void_value, return_type>;
+
+// start child on current context, the child reports to counter when finished
+template<typename return_type>
+inline auto start_when_all_child(task<return_type>& child, fan_in_counter& counter) noexcept -> void
+{
+    child.promise().fan_in(&counter);
+    child.handle().resume();
+}
+
+/**
+ * @brief awaiter of variadic when_all, children are stored in a tuple inside the awaiter and
+ * started one by one on the current context, one fan_in_counter initialized to child number + 1
+ * replaces per child bookkeeping, the extra count belongs to await_suspend so children finished
+ * synchronously never resume the awaiting coroutine before it suspends
+ *
+ * @tparam return_types
+ */
+template<typename... return_types>
+class when_all_awaiter
+{
+    static constexpr bool kAllVoid = (std::is_void_v<return_types> && ...);
+    static constexpr bool kAllSame =
+        sizeof...(return_types) > 0 && (std::is_same_v<return_types, std::tuple_element_t<0, std::tuple<return_types...>>> && ...);
+
+public:
+    explicit when_all_awaiter(task<return_types>&&... children) noexcept
+        : m_children(std::move(children)...),
+          m_counter(sizeof...(return_types) + 1)
+    {
+    }
+
+    when_all_awaiter(const when_all_awaiter&)                    = delete;
+    auto operator=(const when_all_awaiter&) -> when_all_awaiter& = delete;
+
+    auto await_ready() noexcept -> bool { return sizeof...(return_types) == 0; }
+
+    auto await_suspend(std::coroutine_handle<> handle) noexcept -> bool
+    {
+        m_counter.m_awaiting = handle;
+        std::apply([this](auto&... children) { (start_when_all_child(children, m_counter), ...); }, m_children);
+        // 所有子协程已同步完成则不挂起
+        return !m_counter.count_down();
+    }
+
+    /**
+     * @brief all void returns void, all same type returns std::array,
+     * otherwise returns std::tuple and void is replaced by detail::void_value
+     */
+    auto await_resume() -> decltype(auto)
+    {
+        if constexpr (kAllVoid)
+        {
+            std::apply([](auto&... children) { (children.promise().result(), ...); }, m_children);
+        }
+        else if constexpr (kAllSame)
+        {
+            return std::apply(
+                [](auto&... children)
+                {
+                    return std::array<std::tuple_element_t<0, std::tuple<return_types...>>, sizeof...(return_types)>{
+                        std::move(children.promise()).result()...};
+                },
+                m_children);
+        }
+        else
+        {
+            return std::apply(
+                [](auto&... children) { return std::tuple<when_all_value_t<return_types>...>{take_result(children)...}; },
+                m_children);
+        }
+    }
+
+private:
+    template<typename return_type>
+    static auto take_result(task<return_type>& child) -> when_all_value_t<return_type>
+    {
+        if constexpr (std::is_void_v<return_type>)
+        {
+            child.promise().result();
+            return {};
+        }
+        else
+        {
+            return std::move(child.promise()).result();
+        }
+    }
+
+private:
+    std::tuple<task<return_types>...> m_children;
+    fan_in_counter                    m_counter;
+};
 
-// @warning: make compile success, don't use it
 template<typename return_type>
-struct awaiter : public detail::noop_awaiter
+struct scatter_child_awaiter : public task<return_type>::awaitable_base
 {
-    auto await_resume() -> std::array<return_type, 1> { return {}; }
+    // the result stays in child's promise, when_all collects it after all children finished
+    constexpr auto await_resume() noexcept -> void {}
 };
 
-template<>
-struct awaiter<void> : detail::noop_awaiter
+/**
+ * @brief scattered child runs inside a detached wrapper, the wrapper counts down in its own
+ * final_suspend, so the engine which finishes the child only checks and destroys the wrapper frame
+ * after the awaiting coroutine may have been resumed, the child frame is never touched by then
+ *
+ * @param child
+ * @return task<>
+ */
+template<typename return_type>
+auto make_scatter_task(task<return_type>& child) -> task<>
 {
+    co_await scatter_child_awaiter<return_type>{child.handle()};
+}
+
+/**
+ * @brief fan-in counter of scattered children, the last child never transfers to the awaiting
+ * coroutine directly but submits it back to the context it suspended on
+ *
+ */
+struct scatter_counter : public fan_in_counter
+{
+    explicit scatter_counter(size_t count) noexcept : fan_in_counter(count) {}
+
+    static auto on_done(fan_in_counter& counter) noexcept -> std::coroutine_handle<>
+    {
+        auto& self = static_cast<scatter_counter&>(counter);
+        self.m_ctx->submit_task(self.m_awaiting);
+        return std::noop_coroutine();
+    }
+
+    context* m_ctx{nullptr};
 };
 
-template<>
-struct awaiter<std::vector<int>> : public detail::noop_awaiter
+/**
+ * @brief awaiter of range when_all, children stay in the range and the results are collected
+ * into std::vector in range order
+ *
+ * launch_policy::local starts children on the awaiting context one by one, launch_policy::scatter
+ * submits every child in a detached wrapper to the scheduler so the dispatcher spreads them over
+ * all contexts, each child keeps its result in its own promise, the results are moved into the preallocated vector
+ * after the last child finished, so running children never write to shared memory
+ *
+ * @tparam range_type range of task, reference if the range is passed as lvalue
+ */
+template<typename range_type>
+class when_all_range_awaiter
 {
-    auto await_resume() -> std::vector<int> { return {}; }
+    using child_type  = std::remove_cvref_t<std::ranges::range_value_t<std::remove_cvref_t<range_type>>>;
+    using return_type = typename is_task<child_type>::result_type;
+
+public:
+    explicit when_all_range_awaiter(range_type&& children, launch_policy policy) noexcept
+        : m_children(std::forward<range_type>(children)),
+          m_counter(std::ranges::distance(m_children) + 1),
+          m_policy(policy)
+    {
+    }
+
+    when_all_range_awaiter(const when_all_range_awaiter&)                    = delete;
+    auto operator=(const when_all_range_awaiter&) -> when_all_range_awaiter& = delete;
+
+    auto await_ready() noexcept -> bool { return std::ranges::empty(m_children); }
+
+    auto await_suspend(std::coroutine_handle<> handle) noexcept -> bool
+    {
+        m_counter.m_awaiting = handle;
+        if (m_policy == launch_policy::scatter)
+        {
+            // 等待期间本 context 没有就绪任务，登记等待避免被判定为空闲而提前停止
+            m_counter.m_ctx     = &local_context();
+            m_counter.m_on_done = &scatter_counter::on_done;
+            m_counter.m_ctx->register_wait();
+            for (auto& child : m_children)
+            {
+                auto wrapper = make_scatter_task(child);
+                wrapper.promise().fan_in(&m_counter);
+                scheduler::submit(std::move(wrapper));
+            }
+        }
+        else
+        {
+            for (auto& child : m_children)
+            {
+                start_when_all_child(child, m_counter);
+            }
+        }
+        return !m_counter.count_down();
+    }
+
+    auto await_resume() -> decltype(auto)
+    {
+        if (m_counter.m_ctx != nullptr)
+        {
+            m_counter.m_ctx->unregister_wait();
+        }
+        if constexpr (std::is_void_v<return_type>)
+        {
+            for (auto& child : m_children)
+            {
+                child.promise().result();
+            }
+        }
+        else
+        {
+            std::vector<return_type> results;
+            results.reserve(std::ranges::distance(m_children));
+            for (auto& child : m_children)
+            {
+                results.push_back(std::move(child.promise()).result());
+            }
+            return results;
+        }
+    }
+
+private:
+    range_type      m_children;
+    scatter_counter m_counter;
+    launch_policy   m_policy;
 };
 
+}; // namespace detail
+
+/**
+ * @brief wait for all awaitables, children are started on the current context in order
+ *
+ * @param awaitables task is used as child directly, other awaitable is wrapped into task
+ * @return awaiter, co_await it returns void if all children return void, std::array if all
+ * children return the same type, otherwise std::tuple
+ */
 template<concepts::awaitable... awaitables_type>
 [[CORO_TEST_USED(lab5a)]] [[CORO_AWAIT_HINT]] static auto when_all(awaitables_type... awaitables) noexcept
-    -> awaiter<int>
 {
-    // TODO[lab5a] : Add codes if you need,
-    // change return type to awaiter implemented by you
-
-    return {};
+    return [](auto... children) noexcept
+    {
+        return detail::when_all_awaiter<typename detail::is_task<decltype(children)>::result_type...>(
+            std::move(children)...);
+    }(detail::to_when_all_task(std::move(awaitables))...);
 }
 
-// TODO[lab5a] : You can change template parameters if you need
+/**
+ * @brief wait for all tasks in range, an lvalue range is referenced and must be alive until
+ * co_await returns, other awaitables are wrapped into tasks first
+ *
+ * @param awaitables
+ * @param policy launch_policy::scatter dispatches children to all contexts of scheduler,
+ * the awaiting coroutine is resumed on its own context
+ * @return awaiter, co_await it returns void or std::vector of results in range order
+ */
 template<std::ranges::range range_type>
-[[CORO_TEST_USED(lab5a)]] [[CORO_AWAIT_HINT]] static auto when_all(range_type&& awaitables) -> awaiter<std::vector<int>>
+[[CORO_TEST_USED(lab5a)]] [[CORO_AWAIT_HINT]] static auto
+when_all(range_type&& awaitables, launch_policy policy = launch_policy::local)
 {
-    // TODO[lab5a] : Add codes if you need,
-    // change return type to awaiter implemented by you
-    return {};
+    if constexpr (detail::task_type<std::ranges::range_value_t<std::remove_cvref_t<range_type>>>)
+    {
+        return detail::when_all_range_awaiter<range_type>(std::forward<range_type>(awaitables), policy);
+    }
+    else
+    {
+        using child_type = decltype(detail::make_when_all_task(*std::ranges::begin(awaitables)));
+        std::vector<child_type> children;
+        for (auto&& awaitable : awaitables)
+        {
+            children.push_back(detail::make_when_all_task(std::move(awaitable)));
+        }
+        return detail::when_all_range_awaiter<std::vector<child_type>>(std::move(children), policy);
+    }
 }
 }; // namespace coro
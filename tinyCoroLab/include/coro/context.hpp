@@ -12,6 +12,8 @@
 
 #include <atomic>
 #include <memory>
+#include <span>
+#include <stop_token>
 #include <thread>
 
 #include "config.h"
@@ -43,6 +45,7 @@ using std::make_unique;
 using std::memory_order_acq_rel;
 using std::memory_order_acquire;
 using std::memory_order_relaxed;
+using std::stop_source;
 using std::stop_token;
 using std::unique_ptr;
 
@@ -60,7 +63,9 @@ class scheduler;
  */
 class context
 {
-    using stop_cb = std::function<void()>;
+    using stop_cb   = std::function<void()>;
+    using steal_cb  = std::function<bool()>;
+    using notify_cb = std::function<void()>;
 
 public:
     context() noexcept;
@@ -109,6 +114,13 @@ public:
      */
     [[CORO_TEST_USED(lab2b)]] auto submit_task(std::coroutine_handle<> handle) noexcept -> void;
 
+    /**
+     * @brief submit a run of task handles to context, the engine is woken up at most once
+     *
+     * @param handles
+     */
+    auto submit_tasks(std::span<std::coroutine_handle<>> handles) noexcept -> void;
+
     /**
      * @brief get context unique id
      *
@@ -142,6 +154,12 @@ public:
     // TODO[lab2b]: Add more function if you need
     auto set_stop_cb(stop_cb cb) noexcept -> void { m_stop_cb = cb; }
 
+    // 注入任务窃取逻辑，仅在 work_stealing 分发策略下由 scheduler 设置
+    auto set_steal_cb(steal_cb cb) noexcept -> void { m_steal_cb = cb; }
+
+    // 注入唤醒空闲 context 的逻辑，仅在 work_stealing 分发策略下由 scheduler 设置
+    auto set_notify_cb(notify_cb cb) noexcept -> void { m_notify_cb = cb; }
+
     // 驱动 engine 从任务队列取出任务并执行
     auto process_work() noexcept -> void;
 
@@ -158,10 +176,14 @@ private:
     CORO_ALIGN engine   m_engine;
     unique_ptr<jthread> m_job;
     ctx_id              m_id;
+    // 工作线程可能在 m_job 赋值前就调用 stop_cb，所以由 context 自己持有 stop_source
+    stop_source         m_stop_source;
 
     // TODO[lab2b]: Add more member variables if you need
     atomic<size_t> m_num_wait_task{0};
-    stop_cb        m_stop_cb; // context 完成所有任务后应该执行的停止逻辑
+    stop_cb        m_stop_cb;   // context 完成所有任务后应该执行的停止逻辑
+    steal_cb       m_steal_cb;  // context 本地无就绪任务时，从其他 context 窃取任务，返回是否窃取成功
+    notify_cb      m_notify_cb; // context 积压任务时，唤醒一个空闲的 context 来窃取任务
 };
 
 inline context& local_context() noexcept
@@ -5,8 +5,10 @@
 #include "coro/comp/event.hpp"
 #include "coro/comp/latch.hpp"
 #include "coro/comp/mutex.hpp"
+#include "coro/comp/select.hpp"
 #include "coro/comp/wait_group.hpp"
 #include "coro/comp/when_all.hpp"
+#include "coro/io/net/http/server.hpp"
 #include "coro/io/net/tcp/tcp.hpp"
 #include "coro/log.hpp"
 #include "coro/parallel/parallel.hpp"
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+
+#include "coro/context.hpp"
+
+namespace coro::detail
+{
+/**
+ * @brief shared state of one co_await coro::select(...), every source must claim the state
+ * before moving data for the select, so exactly one source wins and the losers never resume
+ * the coroutine
+ *
+ */
+class select_state
+{
+public:
+    static constexpr int kWaiting  = -1;
+    static constexpr int kClaiming = -2;
+
+    /**
+     * @brief try to claim the select, spin while another source holds the claim
+     *
+     * @return true if claimed, caller must call confirm() or abort() later
+     */
+    auto try_claim() noexcept -> bool
+    {
+        int expected = kWaiting;
+        while (!m_winner.compare_exchange_weak(
+            expected, kClaiming, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            if (expected >= 0)
+            {
+                return false;
+            }
+            // 其他来源正在转移数据，持有时间很短，自旋等待结果
+            expected = kWaiting;
+        }
+        return true;
+    }
+
+    // source index wins the select
+    inline auto confirm(int index) noexcept -> void { m_winner.store(index, std::memory_order_release); }
+
+    // source has nothing to move, release the claim
+    inline auto abort() noexcept -> void { m_winner.store(kWaiting, std::memory_order_release); }
+
+    // claim and confirm at once, for source which has no data to move
+    inline auto try_win(int index) noexcept -> bool
+    {
+        if (!try_claim())
+        {
+            return false;
+        }
+        confirm(index);
+        return true;
+    }
+
+    inline auto winner() const noexcept -> int { return m_winner.load(std::memory_order_acquire); }
+
+    inline auto is_won() const noexcept -> bool { return winner() >= 0; }
+
+    /**
+     * @brief called once by the winner after its data is moved and once by await_suspend after
+     * all sources are registered, the latter caller is responsible for resuming the coroutine
+     *
+     * @return true if the caller is the latter one
+     */
+    inline auto complete() noexcept -> bool { return m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+    inline auto resume() noexcept -> void { m_ctx->submit_task(m_handle); }
+
+    context*                m_ctx{nullptr};
+    std::coroutine_handle<> m_handle{nullptr};
+
+private:
+    std::atomic<int> m_winner{kWaiting};
+    std::atomic<int> m_pending{2};
+};
+
+}; // namespace coro::detail
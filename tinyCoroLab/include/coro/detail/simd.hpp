@@ -0,0 +1,65 @@
+/**
+ * @file simd.hpp
+ * @author Jiahui Wang
+ * @brief simd string scanning with runtime dispatch
+ * @version 1.2
+ * @date 2025-06-12
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <cstddef>
+
+#include "coro/detail/types.hpp"
+
+namespace coro::detail::simd
+{
+/**
+ * @brief get the simd level in use, it's the highest level supported by cpu and not higher
+ * than config::kSimdMaxLevel, chosen once at startup
+ *
+ */
+auto level() noexcept -> simd_level;
+
+/**
+ * @brief change the simd level in use, only for benchmark and test, don't call it while
+ * other threads are scanning
+ *
+ * @param lv clamped to the level supported by cpu
+ * @return the level in use after change
+ */
+auto set_level(simd_level lv) noexcept -> simd_level;
+
+/**
+ * @brief find "\r\n\r\n" in [first, last)
+ *
+ * @return the position after "\r\n\r\n", or nullptr if not found
+ */
+auto find_head_end(const char* first, const char* last) noexcept -> const char*;
+
+/**
+ * @brief find the first byte which equals a or b in [first, last)
+ *
+ * @return last if not found
+ */
+auto find_any(const char* first, const char* last, char a, char b) noexcept -> const char*;
+
+/**
+ * @brief write lowercase of src to dst, the same mapping as utils::to_lower(int)
+ *
+ * @param src
+ * @param len
+ * @param dst can be the same as src
+ */
+auto to_lower(const char* src, size_t len, char* dst) noexcept -> void;
+
+/**
+ * @brief compare two strings of the same length case-insensitively, the same mapping as
+ * utils::to_lower(int)
+ *
+ */
+auto iequal(const char* a, const char* b, size_t len) noexcept -> bool;
+
+}; // namespace coro::detail::simd
@@ -17,6 +17,29 @@ enum class schedule_strategy : uint8_t
 enum class dispatch_strategy : uint8_t
 {
     round_robin,
+    work_stealing, // round robin dispatch, idle context steals ready tasks from busy context
+    none
+};
+
+enum class engine_wait_mode : uint8_t
+{
+    eventfd,    // default, submit sqe and then block in eventfd read
+    uring_wait, // submit sqe and wait cqe by one io_uring_enter, task wakeup is delivered by eventfd read sqe
+    none
+};
+
+enum class launch_policy : uint8_t
+{
+    local,   // default, children run on the awaiting context one by one
+    scatter, // children are dispatched to all contexts by scheduler's dispatcher
+    none
+};
+
+enum class simd_level : uint8_t
+{
+    scalar, // portable fallback
+    sse42,  // 16 bytes per step
+    avx2,   // 32 bytes per step
     none
 };
 
@@ -28,6 +51,7 @@ using noop_awaiter = std::suspend_always;
 enum class memory_allocator : uint8_t
 {
     std_allocator,
+    slab, // per thread size class free lists with remote release queue
     none
 };
 
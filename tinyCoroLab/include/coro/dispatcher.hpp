@@ -1,10 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <vector>
 
 #include "coro/context.hpp"
+#include "coro/detail/atomic_helper.hpp"
 #include "coro/detail/types.hpp"
 
 namespace coro::detail
@@ -74,4 +76,115 @@ private:
     std::atomic<size_t> m_cur{0};
 };
 
+/**
+ * @brief work stealing use round robin to dispatch task, but idle context
+ * can steal ready task handles from the busiest context's task queue
+ * 任务窃取
+ * @tparam
+ */
+template<>
+class dispatcher<dispatch_strategy::work_stealing> : public dispatcher<dispatch_strategy::round_robin>
+{
+    using base = dispatcher<dispatch_strategy::round_robin>;
+
+public:
+    void init(size_t ctx_cnt, ctx_container* ctxs) noexcept
+    {
+        base::init(ctx_cnt, ctxs);
+        m_ctx_cnt   = ctx_cnt;
+        m_ctxs      = ctxs;
+        m_idle_flag = idle_flag_type(ctx_cnt, atomic_ref_wrapper<int>{.val = 0});
+        m_idle_cnt  = 0;
+    }
+
+    /**
+     * @brief Mark context may block soon, so it can be waked up when other context has backlog
+     *
+     * @param ctx_id
+     */
+    auto mark_idle(size_t ctx_id) noexcept -> void
+    {
+        if (std::atomic_ref(m_idle_flag[ctx_id].val).exchange(1, std::memory_order_acq_rel) == 0)
+        {
+            m_idle_cnt.fetch_add(1, std::memory_order_acq_rel);
+        }
+    }
+
+    auto mark_busy(size_t ctx_id) noexcept -> void
+    {
+        if (std::atomic_ref(m_idle_flag[ctx_id].val).exchange(0, std::memory_order_acq_rel) == 1)
+        {
+            m_idle_cnt.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    /**
+     * @brief Wake up at most one idle context to steal tasks
+     *
+     * @param ctx_id the id of context which has backlog
+     */
+    auto notify_idle(size_t ctx_id) noexcept -> void
+    {
+        if (m_idle_cnt.load(std::memory_order_acquire) == 0)
+        {
+            return;
+        }
+        for (size_t i = 1; i < m_ctx_cnt; i++)
+        {
+            auto id = (ctx_id + i) % m_ctx_cnt;
+            if (std::atomic_ref(m_idle_flag[id].val).exchange(0, std::memory_order_acq_rel) == 1)
+            {
+                m_idle_cnt.fetch_sub(1, std::memory_order_acq_rel);
+                (*m_ctxs)[id]->get_engine().wake_up();
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Choose the context which has the most ready tasks as victim
+     *
+     * @param thief_id the id of idle context
+     * @return size_t, return thief_id if no context has ready task
+     */
+    auto select_victim(size_t thief_id) noexcept -> size_t
+    {
+        size_t victim_id = thief_id;
+        size_t max_num   = 0;
+        for (size_t i = 1; i < m_ctx_cnt; i++)
+        {
+            auto id  = (thief_id + i) % m_ctx_cnt;
+            auto num = (*m_ctxs)[id]->get_engine().num_task_schedule();
+            if (num > max_num)
+            {
+                max_num   = num;
+                victim_id = id;
+            }
+        }
+        return victim_id;
+    }
+
+    /**
+     * @brief Move at most half of victim's ready tasks to thief
+     *
+     * @param thief_id
+     * @param victim_id
+     * @return size_t the number of stolen tasks
+     */
+    auto steal(size_t thief_id, size_t victim_id) noexcept -> size_t
+    {
+        auto& victim = (*m_ctxs)[victim_id]->get_engine();
+        auto  num    = std::min((victim.num_task_schedule() + 1) / 2, config::kStealBatchSize);
+        return (*m_ctxs)[thief_id]->get_engine().steal_from(victim, num);
+    }
+
+private:
+    using idle_flag_type = std::vector<atomic_ref_wrapper<int>>;
+
+    size_t              m_ctx_cnt{0};
+    ctx_container*      m_ctxs{nullptr};
+    idle_flag_type      m_idle_flag; // 1 means context may be blocked in poll
+    std::atomic<size_t> m_idle_cnt{0};
+};
+
 }; // namespace coro::detail
@@ -15,10 +15,14 @@
 #include <coroutine>
 #include <functional>
 #include <queue>
+#include <span>
+#include <utility>
+#include <vector>
 
 #include "config.h"
 #include "coro/atomic_que.hpp"
 #include "coro/attribute.hpp"
+#include "coro/io/io_info.hpp"
 #include "coro/meta_info.hpp"
 #include "coro/uring_proxy.hpp"
 
@@ -56,6 +60,10 @@ template<typename T>
 // multi producer and multi consumer queue
 using mpmc_queue = AtomicQueue<T>;
 
+template<typename T>
+// single producer and multi consumer queue
+using spmc_queue = SpmcQueue<T, config::kLocalQueCap>;
+
 #define wake_by_task(val) (((val) & engine::task_mask) > 0)
 #define wake_by_io(val)   (((val) & engine::io_mask) > 0)
 #define wake_by_cqe(val)  (((val) & engine::cqe_mask) > 0)
@@ -113,7 +121,7 @@ public:
     /**
      * @brief fetch one task handle and engine should erase it from its queue
      *
-     * @return coroutine_handle<>
+     * @return coroutine_handle<>, nullptr if there is no task handle
      */
     [[CORO_TEST_USED(lab2a)]] [[CORO_DISCARD_HINT]] auto schedule() noexcept -> coroutine_handle<>;
 
@@ -121,10 +129,25 @@ public:
      * 对外调用 提交任务
      * @brief submit one task handle to engine
      *
+     * @note if the caller is the thread owns this engine, handle will be put into lifo slot
+     * without waking up engine, otherwise it will be pushed to task queue and wake up engine
+     * only if engine is sleeping
+     *
      * @param handle
      */
     [[CORO_TEST_USED(lab2a)]] auto submit_task(coroutine_handle<> handle) noexcept -> void;
 
+    /**
+     * @brief submit a run of task handles to engine at once
+     *
+     * @note if the caller is the thread owns this engine, handles are pushed to local queue in
+     * order, otherwise all handles are pushed to task queue first and engine is woken up at most
+     * once, so waking n waiters costs one eventfd write instead of n
+     *
+     * @param handles
+     */
+    auto submit_tasks(std::span<coroutine_handle<>> handles) noexcept -> void;
+
     /**
      * @brief this will call schedule() to fetch one task handle and run it
      *
@@ -143,12 +166,16 @@ public:
      * @brief submit uring sqe and wait uring finish, then handle
      * cqe entry by call handle_cqe_entry
      * 最关键
+     *
+     * @note the way of waiting is decided by config::kEngineWaitMode
      */
     [[CORO_TEST_USED(lab2a)]] auto poll_submit() noexcept -> void;
 
     /**
      * @brief write flag to eventfd to wake up thread blocked by read eventfd
      *
+     * @note this always costs one syscall, even if engine is not sleeping
+     *
      * @param val
      */
     auto wake_up(uint64_t val = engine::task_flag) noexcept -> void;
@@ -159,6 +186,18 @@ public:
      */
     [[CORO_TEST_USED(lab2a)]] auto add_io_submit() noexcept -> void;
 
+    /**
+     * @brief retry an io which can't get free sqe, e.g. resubmission in cqe callback, engine calls
+     * retry(info, 0) at the next poll after pending sqes are submitted, the io counts as running
+     * until then
+     *
+     * @note only called by the thread which owns this engine
+     *
+     * @param info
+     * @param retry prepares sqe again, it can defer the io again if there is still no free sqe
+     */
+    auto defer_io(io::detail::io_info* info, io::detail::cb_type retry) noexcept -> void;
+
     /**
      * @brief return if there has any io to be processed,
      * io include two types: submit_io, running_io
@@ -188,10 +227,29 @@ public:
 
     // TODO[lab2a]: Add more function if you need
 
+    /**
+     * @brief move at most num ready task handles from victim's task queue to this engine,
+     * this is called by the thread owns this engine
+     *
+     * @param victim
+     * @param num
+     * @return size_t the number of stolen task handles
+     */
+    auto steal_from(engine& victim, size_t num) noexcept -> size_t;
+
 private:
     // 提交io
     auto do_io_submit() noexcept -> void;
 
+    // uring_wait 模式下的 poll_submit，提交 sqe 与等待 cqe 合并为一次 io_uring_enter
+    auto poll_submit_and_wait() noexcept -> void;
+
+    // 重新准备因 sqe 耗尽而推迟的 IO，返回 false 表示仍有 IO 被推迟
+    auto retry_deferred_io() noexcept -> bool;
+
+    // 放入本地队列，队列满时放入 task queue，仍然满则放入溢出队列，不会在调用方栈上直接执行
+    auto push_local(coroutine_handle<> handle) noexcept -> void;
+
 private:
     uint32_t    m_id;
     uring_proxy m_upxy;
@@ -200,6 +258,17 @@ private:
     // 非 IO 任务
     mpmc_queue<coroutine_handle<>> m_task_queue; // You can replace it with another data structure
 
+    // 本线程提交的任务，只有本线程 push，其他线程可以窃取
+    spmc_queue<coroutine_handle<>> m_local_queue;
+
+    // 本线程最近提交的任务，下一个执行，不会被窃取；只有本线程写入，使用 atomic 是为了其他线程读取任务数
+    atomic<coroutine_handle<>> m_lifo_slot{nullptr};
+
+    // 本地队列与 task queue 都满时的溢出队列，无界且只有本线程访问，不会被窃取
+    queue<coroutine_handle<>> m_overflow_queue;
+    // 溢出队列长度，其他线程读取任务数时使用
+    atomic<size_t> m_num_overflow{0};
+
     // used to fetch cqe entry
     // 取出完成块
     array<urcptr, config::kQueCap> m_urc;
@@ -207,6 +276,18 @@ private:
     // TODO[lab2a]: Add more member variables if you need
     size_t m_num_io_wait_submit{0}; // 当前待提交的 IO 数
     size_t m_num_io_running{0};     // 正在运行且未完成的 IO 数
+    size_t m_num_lifo_polls{0};     // 连续从 lifo slot 取出任务的次数
+    size_t m_num_schedule{0};       // schedule 调用次数，用于定期检查 task queue
+
+    // cqe 回调中因 sqe 耗尽而推迟到下一次 poll 重新提交的 IO
+    std::vector<std::pair<io::detail::io_info*, io::detail::cb_type>> m_deferred_io;
+
+    // uring_wait 模式下挂起的 eventfd 读请求，其完成不计入 m_num_io_running
+    uint64_t m_efd_buf{0};       // eventfd 读出的值
+    bool     m_efd_armed{false}; // eventfd 读请求是否已挂起
+
+    // 工作线程阻塞在 eventfd 之前置为 true，其他线程提交任务时只有该值为 true 才写 eventfd
+    alignas(config::kCacheLineSize) atomic<bool> m_sleeping{false};
 };
 
 /**
@@ -11,8 +11,13 @@
 #pragma once
 
 #include <netdb.h>
+#include <span>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 #include "coro/io/base_awaiter.hpp"
+#include "coro/io/multishot.hpp"
+#include "coro/io/pooled_buffer.hpp"
 
 namespace coro::io
 {
@@ -60,6 +65,81 @@ public:
     static auto callback(io_info* data, int res) noexcept -> void;
 };
 
+/**
+ * @brief multishot accept, one sqe keeps producing accepted client fds until the stream is destroyed,
+ * co_await next() returns the next client fd or negative errno, fds which aren't fetched are closed
+ * when the stream is destroyed
+ *
+ */
+class tcp_accept_stream : public detail::multishot_stream
+{
+public:
+    struct next_awaiter : public detail::multishot_stream::next_awaiter
+    {
+        auto await_resume() noexcept -> int { return detail::multishot_stream::next_awaiter::await_resume().first; }
+    };
+
+    tcp_accept_stream(int listenfd, int io_flag = 0, int sqe_flag = 0) noexcept;
+
+    auto next() noexcept -> next_awaiter { return next_awaiter{next_cqe()}; }
+
+private:
+    static auto prep(uring::ursptr sqe, detail::multishot_state* state) noexcept -> void;
+
+    static auto drop(detail::multishot_state* state, int32_t res, uint32_t flags) noexcept -> void;
+};
+
+/**
+ * @brief recv without user buffer, kernel picks a buffer from provided buffer ring of local engine
+ * when data arrives, the buffer is returned as pooled_buffer
+ *
+ */
+class tcp_recv_pooled_awaiter : public detail::base_io_awaiter
+{
+public:
+    tcp_recv_pooled_awaiter(int sockfd, int io_flag = 0, int sqe_flag = 0) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+
+    auto await_resume() noexcept -> pooled_buffer;
+
+private:
+    uring::uring_proxy* m_upxy;
+};
+
+/**
+ * @brief multishot recv with provided buffer ring, one sqe keeps receiving data until the peer closes
+ * connection or error occurs, co_await next() returns the next chunk as pooled_buffer
+ *
+ * @note kernel terminates the sqe with -ENOBUFS when buffer ring runs dry, the stream rearms it
+ * instead of returning the error, so release pooled_buffer in time, otherwise it keeps rearming
+ *
+ * @note chunks which aren't fetched are given back to buffer ring when the stream is destroyed,
+ * destroy the stream before closing the connection
+ */
+class tcp_recv_stream : public detail::multishot_stream
+{
+public:
+    struct next_awaiter : public detail::multishot_stream::next_awaiter
+    {
+        uring::uring_proxy* upxy;
+
+        auto await_resume() noexcept -> pooled_buffer;
+    };
+
+    tcp_recv_stream(int sockfd, int io_flag = 0, int sqe_flag = 0) noexcept;
+
+    auto next() noexcept -> next_awaiter
+    {
+        return next_awaiter{next_cqe(), reinterpret_cast<uring::uring_proxy*>(m_state->extra)};
+    }
+
+private:
+    static auto prep(uring::ursptr sqe, detail::multishot_state* state) noexcept -> void;
+
+    static auto drop(detail::multishot_state* state, int32_t res, uint32_t flags) noexcept -> void;
+};
+
 class tcp_write_awaiter : public detail::base_io_awaiter
 {
 public:
@@ -68,6 +148,54 @@ public:
     static auto callback(io_info* data, int res) noexcept -> void;
 };
 
+/**
+ * @brief gather write, all iovecs are sent by one sqe without coalescing copies, short writes
+ * are handled internally by resubmitting the remainder, so co_await returns the total length
+ * or negative errno, the total length must fit in int32_t
+ *
+ * @warning iovecs are advanced in place and must be alive until co_await returns
+ */
+class tcp_writev_awaiter : public detail::base_io_awaiter
+{
+public:
+    tcp_writev_awaiter(int sockfd, std::span<iovec> iov, int sqe_flag = 0) noexcept;
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+
+protected:
+    // sendmsg shares the resubmission logic, only the opcode and msg flags differ
+    tcp_writev_awaiter(int sockfd, std::span<iovec> iov, int io_flag, int sqe_flag, detail::io_type type) noexcept;
+
+    // prepare sqe for the unsent iovecs, at most IOV_MAX iovecs per sqe
+    auto prep(uring::ursptr urs) noexcept -> void;
+
+    // skip n bytes sent, return if all iovecs are sent
+    auto advance(size_t n) noexcept -> bool;
+
+private:
+    int     m_sockfd;
+    int     m_io_flag;
+    int     m_sqe_flag;
+    iovec*  m_iov;
+    size_t  m_iovcnt;
+    int32_t m_written{0};
+    msghdr  m_msg{};
+};
+
+/**
+ * @brief the same as tcp_writev_awaiter but sent by sendmsg, so msg flags like MSG_NOSIGNAL
+ * and MSG_MORE can be used
+ *
+ */
+class tcp_sendmsg_awaiter : public tcp_writev_awaiter
+{
+public:
+    tcp_sendmsg_awaiter(int sockfd, std::span<iovec> iov, int io_flag = 0, int sqe_flag = 0) noexcept
+        : tcp_writev_awaiter(sockfd, iov, io_flag, sqe_flag, detail::io_type::tcp_sendmsg)
+    {
+    }
+};
+
 class tcp_close_awaiter : public detail::base_io_awaiter
 {
 public:
@@ -2,7 +2,7 @@
 
 #include <coroutine>
 #include <cstdint>
-#include <functional>
+#include <type_traits>
 
 namespace coro::io::detail
 {
@@ -12,15 +12,21 @@ namespace coro::io::detail
 struct io_info;
 
 using std::coroutine_handle;
-using cb_type = std::function<void(io_info*, int)>;
+// plain function pointer, every awaiter binds a static member function as callback
+using cb_type = void (*)(io_info*, int);
 
 enum io_type
 {
     nop,
     tcp_accept,
+    tcp_accept_multishot,
     tcp_connect,
     tcp_read,
+    tcp_read_pooled,
+    tcp_read_multishot,
     tcp_write,
+    tcp_writev,
+    tcp_sendmsg,
     tcp_close,
     stdin,
     timer,
@@ -34,8 +40,13 @@ struct io_info
     io_type            type;   // IO 类型
     uintptr_t          data;   // IO 绑定的内存区域
     cb_type            cb;     // IO 绑定的回调函数
+    uint32_t           flags;  // IO 完成时 cqe 的 flags，如 provided buffer 的 buffer id
 };
 
+// io_info 在 cqe 处理路径上被频繁访问，保持为可平凡复制且不超过一个缓存行
+static_assert(std::is_trivially_copyable_v<io_info>);
+static_assert(sizeof(io_info) <= 64);
+
 inline uintptr_t ioinfo_to_ptr(io_info* info) noexcept
 {
     return reinterpret_cast<uintptr_t>(info);
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <utility>
+
+#include "coro/io/io_info.hpp"
+#include "coro/uring_proxy.hpp"
+
+namespace coro::io::detail
+{
+struct multishot_state;
+
+using multishot_prep_type = void (*)(coro::uring::ursptr, multishot_state*);
+using multishot_drop_type = void (*)(multishot_state*, int32_t, uint32_t);
+
+// io_info of the cancel request of multishot sqe
+struct multishot_cancel_info : public io_info
+{
+    multishot_state* state;
+};
+
+/**
+ * @brief state shared by multishot stream and io_uring, one multishot sqe produces cqe continuously,
+ * cqes are cached here until the stream consumes them, so no cqe is lost when no coroutine is waiting
+ *
+ * @note state is allocated in heap and deleted after the stream is destroyed and all requests
+ * referring the state are finished
+ */
+struct multishot_state : public io_info
+{
+    std::deque<std::pair<int32_t, uint32_t>> cqes; // (res, flags) of cqe which isn't consumed
+
+    int  fd;
+    int  io_flag;
+    int  sqe_flag;
+    bool armed{false};        // multishot sqe is still alive in kernel
+    bool detached{false};     // stream is destroyed
+    bool rearm_nobufs{false}; // -ENOBUFS means provided buffer ring is empty, rearm instead of reporting it
+    int  pending{0};          // the number of requests referring this state
+
+    multishot_prep_type   prep;
+    multishot_drop_type   drop; // release resource of the cqe which isn't consumed, can be nullptr
+    multishot_cancel_info cancel_info;
+
+    // the data of derived stream, such as uring_proxy owns provided buffer
+    uintptr_t extra{0};
+
+    static auto callback(io_info* data, int res) noexcept -> void;
+
+    static auto cancel_callback(io_info* data, int res) noexcept -> void;
+
+    // retry cancel which can't get free sqe
+    static auto cancel_retry(io_info* data, int res) noexcept -> void;
+
+    // cancel multishot sqe, deferred to next poll of engine if there is no free sqe
+    auto cancel() noexcept -> void;
+
+    // arm multishot sqe, return false if there is no free sqe
+    auto arm() noexcept -> bool;
+
+    // delete state if it's not referred by stream and kernel
+    auto try_destroy() noexcept -> bool;
+};
+
+/**
+ * @brief base class of multishot stream, stream arms one multishot sqe and co_await next()
+ * returns the result of each cqe, multishot sqe is rearmed automatically if kernel terminates it
+ *
+ * @warning stream must be used and destroyed in the context which creates it
+ */
+class multishot_stream
+{
+public:
+    struct next_awaiter
+    {
+        multishot_state* state;
+
+        auto await_ready() noexcept -> bool { return !state->cqes.empty(); }
+
+        auto await_suspend(std::coroutine_handle<> handle) noexcept -> bool;
+
+        auto await_resume() noexcept -> std::pair<int32_t, uint32_t>
+        {
+            auto cqe = state->cqes.front();
+            state->cqes.pop_front();
+            return cqe;
+        }
+    };
+
+    multishot_stream(int fd, int io_flag, int sqe_flag, multishot_prep_type prep, multishot_drop_type drop) noexcept;
+
+    multishot_stream(const multishot_stream&)                    = delete;
+    auto operator=(const multishot_stream&) -> multishot_stream& = delete;
+
+    multishot_stream(multishot_stream&& other) noexcept : m_state(std::exchange(other.m_state, nullptr)) {}
+
+    auto operator=(multishot_stream&& other) noexcept -> multishot_stream&
+    {
+        if (this != &other)
+        {
+            close();
+            m_state = std::exchange(other.m_state, nullptr);
+        }
+        return *this;
+    }
+
+    ~multishot_stream() noexcept { close(); }
+
+    /**
+     * @brief cancel the multishot sqe and drop cqes which aren't consumed
+     *
+     */
+    auto close() noexcept -> void;
+
+protected:
+    auto next_cqe() noexcept -> next_awaiter { return next_awaiter{.state = m_state}; }
+
+protected:
+    multishot_state* m_state;
+};
+
+}; // namespace coro::io::detail
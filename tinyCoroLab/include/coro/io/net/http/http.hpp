@@ -1,14 +1,213 @@
+/**
+ * @file http.hpp
+ * @author Jiahui Wang
+ * @brief http/1.1 request and response
+ * @version 1.2
+ * @date 2025-06-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
 #pragma once
 
-// TODO: Add http support
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
 namespace coro::io::net::http
 {
-// Avoid the introduction of symbols
-namespace
+enum class method : uint8_t
+{
+    get,
+    head,
+    post,
+    put,
+    del,
+    connect,
+    options,
+    trace,
+    patch,
+    unknown
+};
+
+constexpr size_t kMethodNum = static_cast<size_t>(method::unknown) + 1;
+
+/**
+ * @brief convert method token of request line to method, the token is case-sensitive
+ *
+ * @param token
+ * @return method::unknown if token isn't a standard method
+ */
+auto to_method(std::string_view token) noexcept -> method;
+
+/**
+ * @brief convert method to its token in request line, e.g. "GET" for method::get
+ *
+ * @param m
+ * @return empty string_view for method::unknown
+ */
+auto method_token(method m) noexcept -> std::string_view;
+
+/**
+ * @brief get the reason phrase of status code, e.g. "Not Found" for 404
+ *
+ * @param status
+ * @return empty string_view for unknown status code
+ */
+auto reason_phrase(int status) noexcept -> std::string_view;
+
+/**
+ * @brief header field of request, name and value refer to the read buffer of connection
+ *
+ */
+struct header
+{
+    std::string_view name;
+    std::string_view value;
+};
+
+/**
+ * @brief http request parsed by request_parser, all string_view members refer to the read
+ * buffer of connection directly, they are valid until the response of this request is sent
+ *
+ */
+class request
 {
-}; // namespace
+public:
+    friend class request_parser;
+
+    inline auto get_method() const noexcept -> method { return m_method; }
+
+    // method token as it is in request line, useful for method::unknown
+    inline auto get_method_token() const noexcept -> std::string_view { return m_method_token; }
+
+    // request target, e.g. "/index.html?a=1"
+    inline auto get_target() const noexcept -> std::string_view { return m_target; }
+
+    // path part of target, e.g. "/index.html"
+    inline auto get_path() const noexcept -> std::string_view { return m_path; }
+
+    // query part of target without '?', e.g. "a=1"
+    inline auto get_query() const noexcept -> std::string_view { return m_query; }
+
+    // 0 for HTTP/1.0, 1 for HTTP/1.1
+    inline auto get_version_minor() const noexcept -> int { return m_version_minor; }
+
+    inline auto get_headers() const noexcept -> const std::vector<header>& { return m_headers; }
+
+    /**
+     * @brief find header value by name, name is compared case-insensitively
+     *
+     * @param name
+     * @return empty string_view if header doesn't exist
+     */
+    auto get_header(std::string_view name) const noexcept -> std::string_view;
 
-namespace detail
+    inline auto get_body() const noexcept -> std::string_view { return m_body; }
+
+    // whether the connection can be reused after this request
+    inline auto keep_alive() const noexcept -> bool { return m_keep_alive; }
+
+    // clear request but keep the capacity of header vector
+    auto reset() noexcept -> void;
+
+private:
+    method              m_method{method::unknown};
+    std::string_view    m_method_token;
+    std::string_view    m_target;
+    std::string_view    m_path;
+    std::string_view    m_query;
+    int                 m_version_minor{1};
+    std::vector<header> m_headers;
+    std::string_view    m_body;
+    bool                m_keep_alive{true};
+};
+
+/**
+ * @brief http response built by handler, status line, Content-Length and Connection are
+ * generated when the response is sent, so handler only sets status, extra headers and body
+ *
+ * @note 1xx, 204 and 304 responses never carry body or Content-Length
+ */
+class response
 {
-}; // namespace detail
+public:
+    auto set_status(int status) noexcept -> response&
+    {
+        m_status = status;
+        return *this;
+    }
+
+    /**
+     * @brief append one header, don't set Content-Length or Connection by this
+     *
+     * @param name
+     * @param value
+     */
+    auto add_header(std::string_view name, std::string_view value) -> response&;
+
+    // response owns body
+    auto set_body(std::string body) noexcept -> response&;
+
+    /**
+     * @brief response refers to body without copy, body must be alive until the response is sent,
+     * e.g. static string or the body of request
+     *
+     * @param body
+     */
+    auto set_body_view(std::string_view body) noexcept -> response&;
+
+    // close connection after this response
+    auto set_keep_alive(bool keep_alive) noexcept -> response&
+    {
+        m_keep_alive = keep_alive;
+        return *this;
+    }
+
+    inline auto get_status() const noexcept -> int { return m_status; }
+
+    inline auto get_body() const noexcept -> std::string_view { return m_owned ? m_body : m_body_view; }
+
+    inline auto keep_alive() const noexcept -> bool { return m_keep_alive; }
+
+    /**
+     * @brief prepare response for req, response is reused by connection so the capacity
+     * of header and body string is kept
+     *
+     * @param req
+     */
+    auto reset(const request& req) noexcept -> void;
+
+    /**
+     * @brief append status line and all headers include the empty line to out
+     *
+     * @param out
+     */
+    auto serialize_head(std::string& out) const -> void;
+
+    // HEAD request only sends head
+    inline auto has_body() const noexcept -> bool
+    {
+        return !m_head_only && !bodiless_status() && !get_body().empty();
+    }
+
+private:
+    // status code which forbids body and Content-Length
+    inline auto bodiless_status() const noexcept -> bool
+    {
+        return m_status < 200 || m_status == 204 || m_status == 304;
+    }
+
+private:
+    int              m_status{200};
+    int              m_version_minor{1};
+    bool             m_keep_alive{true};
+    bool             m_head_only{false};
+    bool             m_owned{false};
+    std::string      m_headers; // "name: value\r\n" of extra headers
+    std::string      m_body;
+    std::string_view m_body_view;
+};
+
 }; // namespace coro::io::net::http
@@ -0,0 +1,101 @@
+/**
+ * @file parser.hpp
+ * @author Jiahui Wang
+ * @brief incremental zero-copy http/1.1 request parser
+ * @version 1.2
+ * @date 2025-06-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "coro/io/net/http/http.hpp"
+
+namespace coro::io::net::http
+{
+enum class parse_status : uint8_t
+{
+    complete,
+    partial,
+    error
+};
+
+/**
+ * @brief parse http request from the read buffer of connection without copy, request only
+ * refers to the buffer
+ *
+ * the parser is incremental, while the request head is incomplete it remembers how many bytes
+ * have been scanned, so every byte is scanned once no matter how many reads the head takes,
+ * after the head is found, the head is parsed only when the whole body arrives
+ *
+ * delimiters are searched by coro::detail::simd, which uses sse4.2/avx2 if cpu supports
+ *
+ * @note request body must have Content-Length, chunked request body is answered with 501
+ */
+class request_parser
+{
+public:
+    /**
+     * @brief parse one request at the front of data, data must start at the same position
+     * until complete or error is returned, but it may grow and move between calls
+     *
+     * @param data unparsed bytes of read buffer
+     * @param req filled only if complete is returned
+     * @return parse_status::complete: consumed() returns the length of this request, call
+     * reset() before parsing next request
+     * parse_status::partial: more data is needed
+     * parse_status::error: error_status() returns status code of the error response
+     */
+    auto parse(std::string_view data, request& req) noexcept -> parse_status;
+
+    inline auto consumed() const noexcept -> size_t { return m_skip + m_head_len + m_body_len; }
+
+    inline auto error_status() const noexcept -> int { return m_error; }
+
+    auto reset() noexcept -> void
+    {
+        m_skip     = 0;
+        m_scanned  = 0;
+        m_head_len = 0;
+        m_body_len = 0;
+        m_error    = 0;
+    }
+
+private:
+    enum class connection_type : uint8_t
+    {
+        none,
+        close,
+        keep_alive
+    };
+
+    auto fail(int status) noexcept -> parse_status
+    {
+        m_error = status;
+        return parse_status::error;
+    }
+
+    // parse request line and headers, head doesn't include the last empty line
+    auto parse_head(std::string_view head, request& req) noexcept -> parse_status;
+
+    // parse the line at first, return the position after its "\r\n", or nullptr on error
+    auto parse_request_line(const char* first, const char* last, request& req) noexcept -> const char*;
+
+    auto parse_header_line(const char* first, const char* last, request& req) noexcept -> const char*;
+
+private:
+    size_t          m_skip{0};     // empty lines before request line
+    size_t          m_scanned{0};  // bytes scanned while searching the end of head
+    size_t          m_head_len{0}; // length of head include "\r\n\r\n", 0 means head isn't complete
+    size_t          m_body_len{0};
+    int             m_error{0};
+    bool            m_has_length{false};
+    connection_type m_connection{connection_type::none};
+};
+
+}; // namespace coro::io::net::http
@@ -0,0 +1,146 @@
+/**
+ * @file router.hpp
+ * @author Jiahui Wang
+ * @brief route http request to handler by method and path
+ * @version 1.2
+ * @date 2025-06-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <array>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "coro/io/net/http/http.hpp"
+#include "coro/task.hpp"
+
+namespace coro::io::net::http
+{
+// handler which finishes the response before return
+using handler_type = std::function<void(const request&, response&)>;
+
+// handler which needs co_await, e.g. reads file or calls other service
+using async_handler_type = std::function<task<void>(const request&, response&)>;
+
+/**
+ * @brief handler registered for one method of one path, exactly one of sync and async is set
+ *
+ */
+struct route_handler
+{
+    handler_type       sync;
+    async_handler_type async;
+
+    explicit operator bool() const noexcept { return sync || async; }
+};
+
+/**
+ * @brief router finds handler by method and path
+ *
+ * path is matched exactly first, path registered with trailing '*', e.g. "/static/" + '*',
+ * matches every path starting with "/static/", the longest prefix wins, HEAD request falls back to
+ * GET handler if there is no HEAD handler
+ *
+ * @note register all routes before server starts, router is read only while serving
+ */
+class router
+{
+public:
+    /**
+     * @brief register handler, handler returns void or task<void>
+     *
+     * @param m
+     * @param path exact path, or prefix path ends with '*'
+     * @param handler invoked with (const request&, response&)
+     */
+    template<typename handler_t>
+        requires std::invocable<handler_t&, const request&, response&>
+    auto route(method m, std::string_view path, handler_t&& handler) -> router&
+    {
+        route_handler slot;
+        if constexpr (std::is_same_v<std::invoke_result_t<handler_t&, const request&, response&>, task<void>>)
+        {
+            slot.async = std::forward<handler_t>(handler);
+        }
+        else
+        {
+            slot.sync = std::forward<handler_t>(handler);
+        }
+        add_route(m, path, std::move(slot));
+        return *this;
+    }
+
+    template<typename handler_t>
+    auto get(std::string_view path, handler_t&& handler) -> router&
+    {
+        return route(method::get, path, std::forward<handler_t>(handler));
+    }
+
+    template<typename handler_t>
+    auto post(std::string_view path, handler_t&& handler) -> router&
+    {
+        return route(method::post, path, std::forward<handler_t>(handler));
+    }
+
+    template<typename handler_t>
+    auto put(std::string_view path, handler_t&& handler) -> router&
+    {
+        return route(method::put, path, std::forward<handler_t>(handler));
+    }
+
+    template<typename handler_t>
+    auto del(std::string_view path, handler_t&& handler) -> router&
+    {
+        return route(method::del, path, std::forward<handler_t>(handler));
+    }
+
+    /**
+     * @brief find handler of request
+     *
+     * @param req
+     * @param status set to 404 if no path matches, 405 if path matches but method doesn't,
+     * 501 if method is unknown
+     * @return nullptr if not found
+     */
+    auto match(const request& req, int& status) const noexcept -> const route_handler*;
+
+    /**
+     * @brief get the value of Allow header for path, used by 405 response
+     *
+     * @param path
+     * @return methods registered for path separated by ", ", HEAD is included if GET is registered
+     */
+    auto allow(std::string_view path) const -> std::string;
+
+private:
+    using method_handlers = std::array<route_handler, kMethodNum>;
+
+    // transparent hash so lookup by string_view doesn't construct std::string
+    struct path_hash
+    {
+        using is_transparent = void;
+
+        auto operator()(std::string_view path) const noexcept -> size_t { return std::hash<std::string_view>{}(path); }
+    };
+
+    auto add_route(method m, std::string_view path, route_handler handler) -> void;
+
+    auto find_handler(const method_handlers& handlers, method m) const noexcept -> const route_handler*;
+
+    // exact path first, then the longest prefix, nullptr if no path matches
+    auto find_handlers(std::string_view path) const noexcept -> const method_handlers*;
+
+private:
+    std::unordered_map<std::string, method_handlers, path_hash, std::equal_to<>> m_exact;
+    std::vector<std::pair<std::string, method_handlers>>                         m_prefix; // longest prefix first
+};
+
+}; // namespace coro::io::net::http
@@ -0,0 +1,67 @@
+/**
+ * @file server.hpp
+ * @author Jiahui Wang
+ * @brief http/1.1 server on top of tcp_server
+ * @version 1.2
+ * @date 2025-06-10
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "config.h"
+#include "coro/io/net/http/http.hpp"
+#include "coro/io/net/http/parser.hpp"
+#include "coro/io/net/http/router.hpp"
+#include "coro/task.hpp"
+
+namespace coro::io::net::http
+{
+/**
+ * @brief http/1.1 server, every connection is served by one coroutine submitted to scheduler
+ *
+ * requests are parsed from the read buffer of connection without copy, all pipelined requests
+ * in the buffer are handled in order and their responses are sent by one vectored write,
+ * the connection is kept alive until client asks to close, an error occurs, or
+ * config::kHttpKeepAliveMaxCount requests are served
+ *
+ * @note register routes by get_router() before serve()
+ */
+class http_server
+{
+public:
+    explicit http_server(int port = ::coro::config::kDefaultPort) noexcept : http_server(nullptr, port) {}
+
+    /**
+     * @brief server listens on addr:port when serve() starts
+     *
+     * @param addr nullptr means INADDR_ANY, the string must be alive until serve() starts
+     * @param port
+     */
+    http_server(const char* addr, int port) noexcept : m_addr(addr), m_port(port) {}
+
+    http_server(const http_server&)                    = delete;
+    auto operator=(const http_server&) -> http_server& = delete;
+
+    inline auto get_router() noexcept -> router& { return m_router; }
+
+    /**
+     * @brief listen and accept connections until accept fails with a fatal error such as EBADF,
+     * transient errors like EMFILE are retried after config::kHttpAcceptBackoffMSecond, server must
+     * be alive until all connections are closed
+     *
+     * @return task<>, submit it to scheduler
+     */
+    auto serve() -> task<>;
+
+private:
+    auto serve_connection(int fd) -> task<>;
+
+private:
+    const char* m_addr;
+    int         m_port;
+    router      m_router;
+};
+
+}; // namespace coro::io::net::http
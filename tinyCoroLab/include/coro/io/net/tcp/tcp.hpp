@@ -5,6 +5,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <netdb.h>
+#include <span>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -29,11 +30,60 @@ public:
         return tcp_read_awaiter(m_sockfd, buf, len, io_flags, m_sqe_flag);
     }
 
+    /**
+     * @brief recv data into a buffer borrowed from the provided buffer ring of local engine,
+     * so connection doesn't need to own a read buffer, at most config::kBufRingBufSize bytes
+     * are received at a time
+     *
+     * @param io_flags
+     * @return tcp_recv_pooled_awaiter, co_await it returns pooled_buffer, pooled_buffer::result()
+     * has the same meaning as the return value of read
+     */
+    tcp_recv_pooled_awaiter recv_pooled(int io_flags = 0) noexcept
+    {
+        return tcp_recv_pooled_awaiter(m_sockfd, io_flags, m_sqe_flag);
+    }
+
+    /**
+     * @brief recv data continuously by one multishot sqe with provided buffer ring, this avoids
+     * submitting sqe for each recv on long-lived connection
+     *
+     * @param io_flags
+     * @return tcp_recv_stream, co_await tcp_recv_stream::next() returns pooled_buffer,
+     * pooled_buffer::result() has the same meaning as the return value of read
+     */
+    tcp_recv_stream recv_multishot(int io_flags = 0) noexcept
+    {
+        return tcp_recv_stream(m_sockfd, io_flags, m_sqe_flag);
+    }
+
     tcp_write_awaiter write(char* buf, size_t len, int io_flags = 0) noexcept
     {
         return tcp_write_awaiter(m_sockfd, buf, len, io_flags, m_sqe_flag);
     }
 
+    /**
+     * @brief write all iovecs by one sqe without coalescing them into one buffer, short writes
+     * are resubmitted internally until the whole span is sent
+     *
+     * @param iov iovecs are advanced in place, must be alive until co_await returns
+     * @return tcp_writev_awaiter, co_await it returns the total length or negative errno
+     */
+    tcp_writev_awaiter writev(std::span<iovec> iov) noexcept { return tcp_writev_awaiter(m_sockfd, iov, m_sqe_flag); }
+
+    /**
+     * @brief the same as writev but sent by sendmsg with msg flags, e.g. MSG_NOSIGNAL avoids
+     * SIGPIPE when peer has closed the connection
+     *
+     * @param iov iovecs are advanced in place, must be alive until co_await returns
+     * @param io_flags msg flags of sendmsg
+     * @return tcp_sendmsg_awaiter, co_await it returns the total length or negative errno
+     */
+    tcp_sendmsg_awaiter sendmsg(std::span<iovec> iov, int io_flags = 0) noexcept
+    {
+        return tcp_sendmsg_awaiter(m_sockfd, iov, io_flags, m_sqe_flag);
+    }
+
     // close() must use original sock fd
     tcp_close_awaiter close() noexcept
     {
@@ -54,10 +104,26 @@ class tcp_server
 public:
     explicit tcp_server(int port = ::coro::config::kDefaultPort) noexcept : tcp_server(nullptr, port) {}
 
-    tcp_server(const char* addr, int port) noexcept;
+    /**
+     * @brief listen on addr:port
+     *
+     * @param addr nullptr means INADDR_ANY
+     * @param port
+     * @param backlog length of the pending connection queue passed to listen()
+     */
+    tcp_server(const char* addr, int port, int backlog = ::coro::config::kBacklog) noexcept;
 
     tcp_accept_awaiter accept(int io_flags = 0) noexcept;
 
+    /**
+     * @brief accept connections by one multishot sqe, this reduces sqe submission when lots of
+     * connections arrive at the same time
+     *
+     * @param io_flags
+     * @return tcp_accept_stream, co_await tcp_accept_stream::next() returns client fd
+     */
+    tcp_accept_stream accept_multishot(int io_flags = 0) noexcept;
+
 private:
     int         m_listenfd;
     int         m_port;
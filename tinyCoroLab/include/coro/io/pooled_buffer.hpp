@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "coro/engine.hpp"
+
+namespace coro::io
+{
+/**
+ * @brief pooled_buffer is a borrowed view of one buffer in the provided buffer ring of engine,
+ * the buffer is given back to the ring when pooled_buffer is destroyed or released
+ *
+ * @warning pooled_buffer must be released before the engine which owns the buffer is deinited
+ */
+class pooled_buffer
+{
+public:
+    pooled_buffer() noexcept = default;
+
+    /**
+     * @brief Construct a new pooled buffer object
+     *
+     * @param upxy the uring owns the buffer, nullptr means no buffer is borrowed
+     * @param result the result of recv, bytes received or negative errno
+     * @param bid buffer id chosen by kernel
+     */
+    pooled_buffer(uring::uring_proxy* upxy, int32_t result, uint16_t bid) noexcept
+        : m_upxy(upxy),
+          m_data(upxy != nullptr ? upxy->get_buffer(bid) : nullptr),
+          m_result(result),
+          m_bid(bid)
+    {
+    }
+
+    pooled_buffer(const pooled_buffer&)                    = delete;
+    auto operator=(const pooled_buffer&) -> pooled_buffer& = delete;
+
+    pooled_buffer(pooled_buffer&& other) noexcept
+        : m_upxy(other.m_upxy),
+          m_data(other.m_data),
+          m_result(other.m_result),
+          m_bid(other.m_bid)
+    {
+        other.m_upxy = nullptr;
+        other.m_data = nullptr;
+    }
+
+    auto operator=(pooled_buffer&& other) noexcept -> pooled_buffer&
+    {
+        if (this != &other)
+        {
+            release();
+            m_upxy       = other.m_upxy;
+            m_data       = other.m_data;
+            m_result     = other.m_result;
+            m_bid        = other.m_bid;
+            other.m_upxy = nullptr;
+            other.m_data = nullptr;
+        }
+        return *this;
+    }
+
+    ~pooled_buffer() noexcept { release(); }
+
+    /**
+     * @brief return the result of recv, same as the return value of tcp_connector::read
+     *
+     * @return int32_t
+     */
+    inline auto result() const noexcept -> int32_t { return m_result; }
+
+    inline auto data() const noexcept -> char* { return m_data; }
+
+    inline auto size() const noexcept -> size_t
+    {
+        return m_data != nullptr && m_result > 0 ? static_cast<size_t>(m_result) : 0;
+    }
+
+    inline auto view() const noexcept -> std::string_view { return std::string_view(m_data, size()); }
+
+    /**
+     * @brief return if pooled_buffer holds a buffer
+     *
+     */
+    inline auto valid() const noexcept -> bool { return m_upxy != nullptr; }
+
+    /**
+     * @brief give buffer back to provided buffer ring, if current thread doesn't own the buffer,
+     * the buffer is returned by the owner thread later
+     *
+     */
+    auto release() noexcept -> void
+    {
+        if (m_upxy == nullptr)
+        {
+            return;
+        }
+        auto egn = ::coro::detail::linfo.egn;
+        if (egn != nullptr && &(egn->get_uring()) == m_upxy) [[likely]]
+        {
+            m_upxy->recycle_buffer(m_bid);
+        }
+        else
+        {
+            m_upxy->recycle_buffer_remote(m_bid);
+        }
+        m_upxy = nullptr;
+        m_data = nullptr;
+    }
+
+private:
+    uring::uring_proxy* m_upxy{nullptr};
+    char*               m_data{nullptr};
+    int32_t             m_result{0};
+    uint16_t            m_bid{0};
+};
+
+}; // namespace coro::io
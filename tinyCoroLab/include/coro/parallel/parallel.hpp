@@ -10,11 +10,17 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <functional>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <vector>
 
 #include "coro/comp/when_all.hpp"
 #include "coro/concepts/awaitable.hpp"
 #include "coro/concepts/function_traits.hpp"
+#include "coro/scheduler.hpp"
 
 namespace coro::parallel
 {
@@ -29,7 +35,125 @@ concept parallel_tasks_novoid_type =
     std::ranges::range<type> && ::coro::concepts::awaitable<std::ranges::range_value_t<type>>;
 
 template<typename type>
-concept reduce_operator_input = std::ranges::range<type>;
+using parallel_result_t = std::remove_cvref_t<
+    typename ::coro::concepts::awaitable_traits<std::ranges::range_value_t<type>>::awaiter_return_type>;
+
+// reduce func which collects the whole result vector, receives it by rvalue if possible
+template<typename func_type, typename value_type>
+concept vector_reduce_func = !std::is_void_v<value_type> && (std::invocable<func_type&, std::vector<value_type>&&> ||
+                                                             std::invocable<func_type&, std::vector<value_type>&>);
+
+// binary operation which combines two results, like the op of std::reduce
+template<typename func_type, typename value_type>
+concept binary_reduce_op = !std::is_void_v<value_type> && !vector_reduce_func<func_type, value_type> &&
+                           std::invocable<func_type&, value_type, value_type> &&
+                           std::convertible_to<std::invoke_result_t<func_type&, value_type, value_type>, value_type>;
+
+template<typename func_type, typename value_type>
+using vector_reduce_result_t = std::conditional_t<
+    std::invocable<func_type&, std::vector<value_type>&&>,
+    std::invoke_result<func_type&, std::vector<value_type>&&>,
+    std::invoke_result<func_type&, std::vector<value_type>&>>::type;
+
+// ops which are commutative for arithmetic types, only these may be reordered by std::reduce
+template<typename op_type>
+struct is_commutative_op : std::false_type
+{
+};
+
+template<typename type>
+struct is_commutative_op<std::plus<type>> : std::true_type
+{
+};
+
+template<typename type>
+struct is_commutative_op<std::multiplies<type>> : std::true_type
+{
+};
+
+template<typename type>
+struct is_commutative_op<std::bit_and<type>> : std::true_type
+{
+};
+
+template<typename type>
+struct is_commutative_op<std::bit_or<type>> : std::true_type
+{
+};
+
+template<typename type>
+struct is_commutative_op<std::bit_xor<type>> : std::true_type
+{
+};
+
+template<typename value_type, typename iterator_type, typename op_type>
+concept simd_reduce_path = std::is_arithmetic_v<value_type> &&
+                           std::is_arithmetic_v<std::iter_value_t<iterator_type>> && is_commutative_op<op_type>::value;
+
+template<typename type>
+concept parallel_range_type = std::ranges::random_access_range<type> && std::ranges::sized_range<type>;
+
+// split size elements into one chunk per context if chunk is 0
+inline auto chunk_size(size_t size, size_t chunk) noexcept -> size_t
+{
+    if (chunk == 0)
+    {
+        auto ctx_cnt = std::max<size_t>(scheduler::ctx_count(), 1);
+        chunk        = (size + ctx_cnt - 1) / ctx_cnt;
+    }
+    return std::max<size_t>(chunk, 1);
+}
+
+// only one chunk is not worth dispatching to other context
+inline auto chunk_policy(size_t chunk_num) noexcept -> launch_policy
+{
+    return chunk_num > 1 ? launch_policy::scatter : launch_policy::local;
+}
+
+// one coroutine frame handles a whole chunk instead of one element
+template<typename iterator_type, typename func_type>
+auto for_each_chunk(iterator_type first, iterator_type last, func_type& func) -> task<void>
+{
+    for (; first != last; ++first)
+    {
+        std::invoke(func, *first);
+    }
+    co_return;
+}
+
+// chunk is never empty, the first element starts the partial result so init is applied only once
+template<typename value_type, typename iterator_type, typename op_type>
+auto reduce_chunk(iterator_type first, iterator_type last, op_type& op) -> task<value_type>
+{
+    if constexpr (simd_reduce_path<value_type, iterator_type, op_type>)
+    {
+        // 算术类型且 op 可交换，交给 std::reduce 重排以便向量化
+        co_return std::reduce(std::next(first), last, static_cast<value_type>(*first), op);
+    }
+    else
+    {
+        value_type partial = *first;
+        for (++first; first != last; ++first)
+        {
+            partial = std::invoke(op, std::move(partial), *first);
+        }
+        co_return partial;
+    }
+}
+
+// combine neighbour partial results level by level, keeps range order so op only needs to be associative
+template<typename value_type, typename op_type>
+auto tree_combine(std::vector<value_type>& partials, op_type& op) -> value_type
+{
+    for (size_t stride = 1; stride < partials.size(); stride <<= 1)
+    {
+        for (size_t i = 0; i + stride < partials.size(); i += stride << 1)
+        {
+            partials[i] = std::invoke(op, std::move(partials[i]), std::move(partials[i + stride]));
+        }
+    }
+    return std::move(partials.front());
+}
 }; // namespace detail
 
 // notes: reduce func is used to collect result, like mapreduce
@@ -38,16 +162,18 @@ concept reduce_operator_input = std::ranges::range<type>;
  * @brief Parallel calc but no reduce func
  *
  * @param tasks subtask collections
+ * @param policy subtasks are scattered to all contexts by default
  * @return task<void>
  */
 template<detail::parallel_tasks_void_type tasks_type>
-auto parallel_func(tasks_type&& tasks) -> task<void>
+auto parallel_func(tasks_type&& tasks, launch_policy policy = launch_policy::scatter) -> task<void>
 {
-    co_await when_all(std::forward<tasks_type>(tasks));
+    co_await when_all(std::forward<tasks_type>(tasks), policy);
 }
 
 /**
- * @brief Convert any funciton object to std::function
+ * @brief Convert any funciton object to std::function, parallel_func accepts any invocable
+ * directly, this is kept for compatibility
  *
  * @tparam func_type
  */
@@ -63,21 +189,120 @@ requires(coro::concepts::function_traits<func_type>::arity == 1) auto make_paral
  * @brief Parallel calc with reduce func to collect result
  *
  * @tparam tasks_type
- * @tparam input_type: the input parameter of reduce func
- * @tparam return_type
- * @tparam ::coro::concepts::awaitable_traits<std::ranges::range_value_t<tasks_type>>::awaiter_return_type
+ * @tparam reduce_type: any invocable accepts std::vector of results, the vector is moved in if
+ * reduce accepts rvalue, otherwise passed by reference, never copied
+ * @param policy subtasks are scattered to all contexts by default
+ */
+template<
+    detail::parallel_tasks_novoid_type tasks_type,
+    typename reduce_type,
+    typename value_type = detail::parallel_result_t<tasks_type>>
+    requires detail::vector_reduce_func<reduce_type, value_type>
+auto parallel_func(tasks_type&& tasks, reduce_type reduce, launch_policy policy = launch_policy::scatter)
+    -> task<detail::vector_reduce_result_t<reduce_type, value_type>>
+{
+    auto result = co_await when_all(std::forward<tasks_type>(tasks), policy);
+    if constexpr (std::invocable<reduce_type&, std::vector<value_type>&&>)
+    {
+        co_return std::invoke(reduce, std::move(result));
+    }
+    else
+    {
+        co_return std::invoke(reduce, result);
+    }
+}
+
+/**
+ * @brief Parallel calc with binary op to combine results, e.g. std::plus<>{}, returns value_type{}
+ * if there is no subtask
+ *
+ * @tparam tasks_type
+ * @tparam op_type: op(value_type, value_type) must be associative, results are combined in
+ * subtask order, only arithmetic results with commutative op (std::plus etc.) are combined by
+ * std::reduce which may reorder them
+ * @param policy subtasks are scattered to all contexts by default
  */
 template<
     detail::parallel_tasks_novoid_type tasks_type,
-    detail::reduce_operator_input      input_type,
-    typename return_type,
-    typename task_return_type =
-        typename ::coro::concepts::awaitable_traits<std::ranges::range_value_t<tasks_type>>::awaiter_return_type>
-requires(std::is_same_v<task_return_type, std::ranges::range_value_t<input_type>>) auto parallel_func(
-    tasks_type&& tasks, std::function<return_type(input_type)> reduce) -> task<return_type>
-{
-    auto result = co_await when_all(std::forward<tasks_type>(tasks));
-    co_return reduce(result);
+    typename op_type,
+    typename value_type = detail::parallel_result_t<tasks_type>>
+    requires detail::binary_reduce_op<op_type, value_type>
+auto parallel_func(tasks_type&& tasks, op_type op, launch_policy policy = launch_policy::scatter) -> task<value_type>
+{
+    auto result = co_await when_all(std::forward<tasks_type>(tasks), policy);
+    if (result.empty())
+    {
+        co_return value_type{};
+    }
+    auto first = std::next(result.begin());
+    if constexpr (std::is_arithmetic_v<value_type> && detail::is_commutative_op<op_type>::value)
+    {
+        co_return std::reduce(first, result.end(), result.front(), op);
+    }
+    else
+    {
+        co_return std::accumulate(
+            std::make_move_iterator(first), std::make_move_iterator(result.end()), std::move(result.front()), op);
+    }
+}
+
+/**
+ * @brief apply func to every element of range, the range is split into chunks and every chunk
+ * is handled by one coroutine, chunks are scattered to all contexts
+ *
+ * @param range random access range, must be alive until co_await returns
+ * @param chunk element number of each chunk, 0 means one chunk per context
+ * @param func invoked with each element
+ * @return task<void>
+ */
+template<detail::parallel_range_type range_type, typename func_type>
+    requires std::invocable<func_type&, std::ranges::range_reference_t<range_type>>
+auto for_each(range_type&& range, size_t chunk, func_type func) -> task<void>
+{
+    auto size = static_cast<size_t>(std::ranges::size(range));
+    chunk     = detail::chunk_size(size, chunk);
+
+    std::vector<task<void>> chunks;
+    chunks.reserve((size + chunk - 1) / chunk);
+    auto first = std::ranges::begin(range);
+    for (size_t offset = 0; offset < size; offset += chunk)
+    {
+        auto len = std::min(chunk, size - offset);
+        chunks.push_back(detail::for_each_chunk(first + offset, first + offset + len, func));
+    }
+    co_await when_all(chunks, detail::chunk_policy(chunks.size()));
+}
+
+/**
+ * @brief reduce range with op, the range is split into one chunk per context, every chunk is
+ * reduced by one coroutine, then the partial results are combined tree-wise and init is combined
+ * last, op must be associative
+ *
+ * @param range random access range, must be alive until co_await returns
+ * @param init initial value, also decides the result type
+ * @param op binary operation, op(value_type, element) and op(value_type, value_type)
+ * @return task<value_type>
+ */
+template<detail::parallel_range_type range_type, typename value_type, typename op_type = std::plus<>>
+auto reduce(range_type&& range, value_type init, op_type op = {}) -> task<value_type>
+{
+    auto size = static_cast<size_t>(std::ranges::size(range));
+    if (size == 0)
+    {
+        co_return init;
+    }
+    auto chunk = detail::chunk_size(size, 0);
+
+    std::vector<task<value_type>> chunks;
+    chunks.reserve((size + chunk - 1) / chunk);
+    auto first = std::ranges::begin(range);
+    for (size_t offset = 0; offset < size; offset += chunk)
+    {
+        auto len = std::min(chunk, size - offset);
+        chunks.push_back(detail::reduce_chunk<value_type>(first + offset, first + offset + len, op));
+    }
+    auto partials = co_await when_all(chunks, detail::chunk_policy(chunks.size()));
+    co_return std::invoke(op, std::move(init), detail::tree_combine(partials, op));
 }
 
 }; // namespace coro::parallel
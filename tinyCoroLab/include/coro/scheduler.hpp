@@ -53,6 +53,12 @@ public:
      */
     [[CORO_TEST_USED(lab2b)]] inline static auto loop() noexcept -> void { get_instance()->loop_impl(); }
 
+    /**
+     * @brief the number of contexts, parallel algorithms use it to split work
+     *
+     */
+    inline static auto ctx_count() noexcept -> size_t { return get_instance()->m_ctx_cnt; }
+
     static inline auto submit(task<void>&& task) noexcept -> void
     {
         auto handle = task.handle();
@@ -86,6 +92,25 @@ private:
 
     // TODO[lab2b]: Add more function if you need
 
+    /**
+     * @brief idle context steal ready tasks from the busiest context,
+     * only used by work_stealing dispatch strategy
+     *
+     * @param ctx_id the id of idle context
+     * @return true if steal success
+     */
+    template<detail::dispatch_strategy dst = config::kDispatchStrategy>
+    auto steal_task_impl(size_t ctx_id) noexcept -> bool;
+
+    /**
+     * @brief context which has backlog wake up one idle context to steal tasks,
+     * only used by work_stealing dispatch strategy
+     *
+     * @param ctx_id the id of context which has backlog
+     */
+    template<detail::dispatch_strategy dst = config::kDispatchStrategy>
+    auto notify_idle_impl(size_t ctx_id) noexcept -> void;
+
 private:
     size_t                                              m_ctx_cnt{0};
     detail::ctx_container                               m_ctxs;
@@ -13,6 +13,16 @@ using std::memory_order_acquire;
 using std::memory_order_relaxed;
 using std::memory_order_release;
 
+// Issue X86 PAUSE instruction to reduce contention between hyper-threads while spinning
+inline auto cpu_relax() noexcept -> void
+{
+#if defined(_MSC_VER)
+    _mm_pause();
+#else
+    __builtin_ia32_pause();
+#endif
+}
+
 struct spinlock
 {
     atomic<bool> lock_ = {0};
@@ -29,16 +39,7 @@ struct spinlock
             // Wait for lock to be released without generating cache misses
             while (lock_.load(memory_order_relaxed))
             {
-                // Issue X86 PAUSE or ARM YIELD instruction to reduce contention between
-                // hyper-threads
-
-#if defined(__GNUC__) || defined(__clang__)
-                __builtin_ia32_pause();
-#elif defined(_MSC_VER)
-                _mm_pause();
-#else
-                __builtin_ia32_pause();
-#endif
+                cpu_relax();
             }
         }
     }
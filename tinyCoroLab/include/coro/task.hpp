@@ -10,6 +10,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <coroutine>
 #include <cstddef>
@@ -53,6 +54,29 @@ enum class coro_state : uint8_t
     none
 };
 
+/**
+ * @brief fan-in counter shared by the children of when_all, each finished child counts down once
+ * and the last one resumes the awaiting coroutine, the counter lives in the when_all awaiter,
+ * so waiting for children allocates nothing
+ *
+ */
+struct fan_in_counter
+{
+    explicit fan_in_counter(size_t count) noexcept : m_count(count) {}
+
+    using done_type = auto (*)(fan_in_counter&) noexcept -> std::coroutine_handle<>;
+
+    // return true if the caller is the last one
+    inline auto count_down() noexcept -> bool { return m_count.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+    // called by the last child, return the handle which the child transfers to
+    inline auto done() noexcept -> std::coroutine_handle<> { return m_on_done ? m_on_done(*this) : m_awaiting; }
+
+    std::atomic<size_t>     m_count;
+    std::coroutine_handle<> m_awaiting{nullptr};
+    done_type               m_on_done{nullptr};
+};
+
 struct promise_base
 {
     friend struct final_awaitable;
@@ -66,6 +90,12 @@ struct promise_base
         {
             // coroutine 子协程
             auto& promise = coroutine.promise();
+            if (promise.m_fan_in != nullptr)
+            {
+                // when_all 的子协程，最后一个结束的子协程恢复等待者
+                auto counter = promise.m_fan_in;
+                return counter->count_down() ? counter->done() : std::noop_coroutine();
+            }
             return promise.m_continuation != nullptr ? promise.m_continuation : std::noop_coroutine();
         }
 
@@ -88,6 +118,8 @@ struct promise_base
 
     auto continuation(std::coroutine_handle<> continuation) noexcept -> void { m_continuation = continuation; }
 
+    auto fan_in(fan_in_counter* counter) noexcept -> void { m_fan_in = counter; }
+
     auto set_state(coro_state state) -> void { m_state = state; }
 
     auto get_state() -> coro_state { return m_state; }
@@ -95,16 +127,29 @@ struct promise_base
     auto is_detach() -> bool { return m_state == coro_state::detach; }
 
 #ifdef ENABLE_MEMORY_ALLOC
+    #ifdef ENABLE_MEMORY_PROFILE
+    void* operator new(std::size_t size)
+    {
+        return ::coro::allocator::memory::frame_profiler::allocate(::coro::detail::ginfo.mem_alloc, size);
+    }
+
+    void operator delete(void* ptr, [[CORO_MAYBE_UNUSED]] std::size_t size)
+    {
+        ::coro::allocator::memory::frame_profiler::release(::coro::detail::ginfo.mem_alloc, ptr);
+    }
+    #else
     void* operator new(std::size_t size) { return ::coro::detail::ginfo.mem_alloc->allocate(size); }
 
     void operator delete(void* ptr, [[CORO_MAYBE_UNUSED]] std::size_t size)
     {
         ::coro::detail::ginfo.mem_alloc->release(ptr);
     }
+    #endif
 #endif
 
 protected:
     std::coroutine_handle<> m_continuation{nullptr};
+    fan_in_counter*         m_fan_in{nullptr};
     coro_state              m_state{coro_state::normal};
 
 #ifdef DEBUG
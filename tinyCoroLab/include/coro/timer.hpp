@@ -40,7 +40,7 @@ inline auto get_kernel_timespec(std::chrono::duration<Rep, Period> time_duration
 {
     auto seconds     = std::chrono::duration_cast<std::chrono::seconds>(time_duration);
     auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(time_duration - seconds);
-    return __kernel_timespec{.tv_sec = seconds, .tv_nsec = nanoseconds};
+    return __kernel_timespec{.tv_sec = seconds.count(), .tv_nsec = nanoseconds.count()};
 }
 
 /**
@@ -192,7 +192,7 @@ public:
     }
 
 private:
-    __kernel_timespec m_ts;
+    __kernel_timespec m_ts{};
     unsigned          m_flag{0};
 };
 
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
 #include <functional>
 #include <liburing.h>
+#include <mutex>
+#include <poll.h>
 #include <sys/eventfd.h>
 #include <vector>
 // #ifdef ENABLE_SQPOOL
@@ -60,11 +63,15 @@ public:
             std::exit(1);
         }
 
-        res = io_uring_register_eventfd(&m_uring, m_efd);
-        if (res != 0)
+        // uring_wait mode waits cqe by io_uring_enter, io completion doesn't need to notify eventfd
+        if constexpr (config::kEngineWaitMode == ::coro::detail::engine_wait_mode::eventfd)
         {
-            log::error("uring_proxy bind event_fd to uring failed");
-            std::exit(1);
+            res = io_uring_register_eventfd(&m_uring, m_efd);
+            if (res != 0)
+            {
+                log::error("uring_proxy bind event_fd to uring failed");
+                std::exit(1);
+            }
         }
 
         if constexpr (config::kEnableFixfd)
@@ -110,6 +117,15 @@ public:
             }
         }
 
+        if (m_buf_ring != nullptr)
+        {
+            io_uring_free_buf_ring(&m_uring, m_buf_ring, config::kBufRingEntries, config::kBufRingGroupId);
+            free(m_buf_base);
+            m_buf_ring = nullptr;
+            m_buf_base = nullptr;
+        }
+        m_remote_bids.clear();
+
         io_uring_queue_exit(&m_uring);
     }
 
@@ -178,6 +194,30 @@ public:
         return io_uring_submit(&m_uring);
     }
 
+    /**
+     * @brief submit all sqe entry and wait at least wait_nr cqe entry by one syscall
+     *
+     * @note block function if wait_nr > 0
+     *
+     * @param wait_nr
+     * @return int the number of submitted sqe entry
+     */
+    inline auto submit_and_wait(unsigned int wait_nr) noexcept -> int CORO_INLINE
+    {
+        return io_uring_submit_and_wait(&m_uring, wait_nr);
+    }
+
+    /**
+     * @brief prepare a read request of eventfd, the request will complete when eventfd is written
+     *
+     * @param sqe
+     * @param buf store the value read from eventfd
+     */
+    inline auto prep_read_eventfd(ursptr sqe, uint64_t* buf) noexcept -> void CORO_INLINE
+    {
+        io_uring_prep_read(sqe, m_efd, buf, sizeof(uint64_t), 0);
+    }
+
     /**
      * @brief use io_uring_for_each_cqe to process cqe entry
      *
@@ -210,6 +250,21 @@ public:
         return u;
     }
 
+    /**
+     * @brief block until eventfd is written or cqe arrives, eventfd is read if it's written,
+     * used by uring_wait mode when no sqe is free to arm the eventfd read
+     *
+     */
+    auto wait_eventfd_or_cqe() noexcept -> void
+    {
+        pollfd fds[2] = {
+            {.fd = m_efd, .events = POLLIN, .revents = 0}, {.fd = m_uring.ring_fd, .events = POLLIN, .revents = 0}};
+        if (::poll(fds, 2, -1) > 0 && (fds[0].revents & POLLIN))
+        {
+            wait_eventfd();
+        }
+    }
+
     /**
      * @brief batch fetch cqe entry
      *
@@ -284,6 +339,119 @@ public:
         }
     }
 
+    /**
+     * @brief register provided buffer ring to uring if it hasn't been registered, all buffers are
+     * given to kernel, so recv with IOSQE_BUFFER_SELECT can pick one when data arrives
+     *
+     * @note only called by the thread which owns the uring
+     *
+     * @return true if buffer ring is available
+     */
+    auto init_buf_ring() noexcept -> bool
+    {
+        if constexpr (!config::kEnableBufRing)
+        {
+            return false;
+        }
+        if (m_buf_ring != nullptr) [[likely]]
+        {
+            return true;
+        }
+
+        int ret;
+        m_buf_ring =
+            io_uring_setup_buf_ring(&m_uring, config::kBufRingEntries, config::kBufRingGroupId, 0, &ret);
+        if (m_buf_ring == nullptr)
+        {
+            log::warn("uring_proxy register buffer ring failed, result: {}", ret);
+            return false;
+        }
+        m_buf_base = static_cast<char*>(malloc(size_t(config::kBufRingEntries) * config::kBufRingBufSize));
+        if (m_buf_base == nullptr)
+        {
+            log::error("uring_proxy alloc buffers of buffer ring failed");
+            io_uring_free_buf_ring(&m_uring, m_buf_ring, config::kBufRingEntries, config::kBufRingGroupId);
+            m_buf_ring = nullptr;
+            return false;
+        }
+        for (unsigned int bid = 0; bid < config::kBufRingEntries; bid++)
+        {
+            add_buffer(bid, bid);
+        }
+        io_uring_buf_ring_advance(m_buf_ring, config::kBufRingEntries);
+        return true;
+    }
+
+    /**
+     * @brief get the buffer of buffer id chosen by kernel
+     *
+     * @param bid
+     * @return char*
+     */
+    inline auto get_buffer(uint16_t bid) noexcept -> char* CORO_INLINE
+    {
+        return m_buf_base + size_t(bid) * config::kBufRingBufSize;
+    }
+
+    /**
+     * @brief give buffer back to kernel
+     *
+     * @note only called by the thread which owns the uring
+     *
+     * @param bid
+     */
+    inline auto recycle_buffer(uint16_t bid) noexcept -> void CORO_INLINE
+    {
+        add_buffer(bid, 0);
+        io_uring_buf_ring_advance(m_buf_ring, 1);
+    }
+
+    /**
+     * @brief give buffer back from the thread which doesn't own the uring, the buffer will be
+     * returned to kernel when owner thread calls drain_remote_buffers
+     *
+     * @param bid
+     */
+    auto recycle_buffer_remote(uint16_t bid) noexcept -> void
+    {
+        std::lock_guard lock(m_remote_mtx);
+        m_remote_bids.push_back(bid);
+        m_has_remote_bids.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief give buffers recycled by other threads back to kernel
+     *
+     * @note only called by the thread which owns the uring
+     */
+    auto drain_remote_buffers() noexcept -> void
+    {
+        if (!m_has_remote_bids.load(std::memory_order_acquire)) [[likely]]
+        {
+            return;
+        }
+        std::lock_guard lock(m_remote_mtx);
+        for (size_t i = 0; i < m_remote_bids.size(); i++)
+        {
+            add_buffer(m_remote_bids[i], i);
+        }
+        io_uring_buf_ring_advance(m_buf_ring, m_remote_bids.size());
+        m_remote_bids.clear();
+        m_has_remote_bids.store(false, std::memory_order_relaxed);
+    }
+
+private:
+    inline auto add_buffer(uint16_t bid, int offset) noexcept -> void CORO_INLINE
+    {
+        io_uring_buf_ring_add(
+            m_buf_ring,
+            get_buffer(bid),
+            config::kBufRingBufSize,
+            bid,
+            io_uring_buf_ring_mask(config::kBufRingEntries),
+            offset);
+    }
+
 private:
     int             m_efd{0};
     io_uring_params m_para;
@@ -292,6 +460,15 @@ private:
     // Use m_fds to utilize the IOSQE_FIXED_FILE feature of io_uring
     std::vector<int>                                            m_null_fds;
     ::coro::detail::marked_buffer<int, config::kFixFdArraySize> m_fds;
+
+    // provided buffer ring, registered lazily by init_buf_ring
+    io_uring_buf_ring* m_buf_ring{nullptr};
+    char*              m_buf_base{nullptr};
+
+    // buffer ids released by other threads
+    std::mutex            m_remote_mtx;
+    std::vector<uint16_t> m_remote_bids;
+    std::atomic<bool>     m_has_remote_bids{false};
 };
 
 }; // namespace coro::uring
\ No newline at end of file
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <limits>
 #include <regex>
 #include <string>
+#include <string_view>
 #include <thread>
 
+#include "coro/detail/simd.hpp"
+
 namespace coro::utils
 {
 /**
@@ -78,18 +83,36 @@ inline auto to_lower(int c) -> unsigned char
  */
 struct hash
 {
-    auto operator()(const std::string& key) const -> size_t { return hash_core(key.data(), key.size(), 0); }
+    using is_transparent = void;
+
+    auto operator()(std::string_view key) const -> size_t
+    {
+        // 先分块批量转换为小写，再按 hash_core 相同的递推计算，结果与 hash_core 一致
+        char   buf[32];
+        size_t h = 0;
+        for (size_t i = 0; i < key.size(); i += sizeof(buf))
+        {
+            auto n = std::min(sizeof(buf), key.size() - i);
+            detail::simd::to_lower(key.data() + i, n, buf);
+            for (size_t j = 0; j < n; j++)
+            {
+                h = mix(h, buf[j]);
+            }
+        }
+        return h;
+    }
 
     auto hash_core(const char* s, size_t l, size_t h) const -> size_t
     {
-        return (l == 0) ? h
-                        : hash_core(
-                              s + 1,
-                              l - 1,
-                              // Unsets the 6 high bits of h, therefore no
-                              // overflow happens
-                              (((std::numeric_limits<size_t>::max)() >> 6) & h * 33) ^
-                                  static_cast<unsigned char>(to_lower(*s)));
+        return (l == 0) ? h : hash_core(s + 1, l - 1, mix(h, static_cast<char>(to_lower(*s))));
+    }
+
+private:
+    static auto mix(size_t h, char lower) noexcept -> size_t
+    {
+        // Unsets the 6 high bits of h, therefore no
+        // overflow happens
+        return (((std::numeric_limits<size_t>::max)() >> 6) & h * 33) ^ static_cast<unsigned char>(lower);
     }
 };
 
@@ -98,15 +121,16 @@ struct hash
  *
  * @warning case insensitive
  */
-inline auto equal(const std::string& a, const std::string& b) -> bool
+inline auto equal(std::string_view a, std::string_view b) -> bool
 {
-    return a.size() == b.size() &&
-           std::equal(a.begin(), a.end(), b.begin(), [](char ca, char cb) { return to_lower(ca) == to_lower(cb); });
+    return a.size() == b.size() && detail::simd::iequal(a.data(), b.data(), a.size());
 }
 
 struct equal_to
 {
-    auto operator()(const std::string& a, const std::string& b) const -> bool { return equal(a, b); }
+    using is_transparent = void;
+
+    auto operator()(std::string_view a, std::string_view b) const -> bool { return equal(a, b); }
 };
 
 /**
@@ -3,5 +3,162 @@
 
 namespace coro
 {
-// TODO[lab5b] : Add codes if you need
+condition_variable::cv_awaiter::cv_awaiter(context& ctx, mutex& mtx, condition_variable& cv) noexcept
+    : mutex_awaiter(ctx, mtx),
+      m_cv(cv)
+{
+    m_resume = &cv_awaiter::on_locked;
+}
+
+condition_variable::cv_awaiter::cv_awaiter(
+    context& ctx, mutex& mtx, condition_variable& cv, cond_type& cond) noexcept
+    : mutex_awaiter(ctx, mtx),
+      m_cv(cv),
+      m_cond_ref(&cond)
+{
+    m_resume = &cv_awaiter::on_locked;
+}
+
+condition_variable::cv_awaiter::cv_awaiter(
+    context& ctx, mutex& mtx, condition_variable& cv, cond_type&& cond) noexcept
+    : mutex_awaiter(ctx, mtx),
+      m_cv(cv),
+      m_cond(std::move(cond))
+{
+    m_resume = &cv_awaiter::on_locked;
+}
+
+auto condition_variable::cv_awaiter::await_ready() noexcept -> bool
+{
+    m_ctx.register_wait();
+    // 持有锁时条件已满足则不等待
+    return has_cond() && check_cond();
+}
+
+auto condition_variable::cv_awaiter::await_suspend(std::coroutine_handle<> handle) noexcept -> bool
+{
+    m_await_coro = handle;
+    // 先挂到等待链表再释放锁，保证释放锁之后的 notify 一定能看到该 awaiter
+    m_cv.push_waiter(this);
+    m_mtx.unlock();
+    return true;
+}
+
+auto condition_variable::cv_awaiter::on_locked(mutex::mutex_awaiter* waiter) noexcept -> bool
+{
+    auto self = static_cast<cv_awaiter*>(waiter);
+    // 已持有锁，条件不满足时不恢复协程，重新等待并拒绝锁
+    if (self->has_cond() && !self->check_cond())
+    {
+        self->m_cv.push_waiter(self);
+        return false;
+    }
+    self->m_ctx.submit_task(self->m_await_coro);
+    return true;
+}
+
+auto condition_variable::wait(mutex& mtx) noexcept -> cv_awaiter
+{
+    return cv_awaiter(local_context(), mtx, *this);
+}
+
+auto condition_variable::wait(mutex& mtx, cond_type&& cond) noexcept -> cv_awaiter
+{
+    return cv_awaiter(local_context(), mtx, *this, std::move(cond));
+}
+
+auto condition_variable::wait(mutex& mtx, cond_type& cond) noexcept -> cv_awaiter
+{
+    return cv_awaiter(local_context(), mtx, *this, cond);
+}
+
+auto condition_variable::notify_one() noexcept -> void
+{
+    cv_awaiter* waiter = nullptr;
+    {
+        std::lock_guard<detail::spinlock> lck(m_lock);
+        if (m_head == nullptr)
+        {
+            take_waiters();
+        }
+        waiter = m_head;
+        if (waiter != nullptr)
+        {
+            m_head = static_cast<cv_awaiter*>(waiter->m_next);
+            if (m_head == nullptr)
+            {
+                m_tail = nullptr;
+            }
+        }
+    }
+    if (waiter != nullptr)
+    {
+        waiter->m_next = nullptr;
+        waiter->m_mtx.lock_chain(waiter, waiter);
+    }
+}
+
+auto condition_variable::notify_all() noexcept -> void
+{
+    cv_awaiter* head = nullptr;
+    {
+        std::lock_guard<detail::spinlock> lck(m_lock);
+        take_waiters();
+        head   = m_head;
+        m_head = nullptr;
+        m_tail = nullptr;
+    }
+
+    // 按 mutex 分段，每段一次性挂到对应 mutex 的等待链表，通常所有等待者共用一个 mutex
+    while (head != nullptr)
+    {
+        auto first = head;
+        auto last  = head;
+        while (last->m_next != nullptr && &last->m_next->m_mtx == &first->m_mtx)
+        {
+            last = static_cast<cv_awaiter*>(last->m_next);
+        }
+        head         = static_cast<cv_awaiter*>(last->m_next);
+        last->m_next = nullptr;
+        first->m_mtx.lock_chain(first, last);
+    }
+}
+
+auto condition_variable::push_waiter(cv_awaiter* waiter) noexcept -> void
+{
+    auto state = m_state.load(std::memory_order_acquire);
+    do
+    {
+        waiter->m_next = state;
+    } while (!m_state.compare_exchange_weak(state, waiter, std::memory_order_release, std::memory_order_acquire));
+}
+
+auto condition_variable::take_waiters() noexcept -> void
+{
+    auto waiter = m_state.exchange(nullptr, std::memory_order_acq_rel);
+    if (waiter == nullptr)
+    {
+        return;
+    }
+    // 链表为栈序，反转为 FIFO 后接到队尾
+    cv_awaiter* first = nullptr;
+    auto        last  = waiter;
+    while (waiter != nullptr)
+    {
+        auto next      = static_cast<cv_awaiter*>(waiter->m_next);
+        waiter->m_next = first;
+        first          = waiter;
+        waiter         = next;
+    }
+    if (m_tail == nullptr)
+    {
+        m_head = first;
+    }
+    else
+    {
+        m_tail->m_next = first;
+    }
+    m_tail = last;
+}
+
 } // namespace coro
@@ -1,7 +1,10 @@
 #include "coro/comp/event.hpp"
 #include "coro/detail/types.hpp"
 #include "coro/scheduler.hpp"
+#include <array>
 #include <atomic>
+#include <mutex>
+#include <thread>
 
 namespace coro
 {
@@ -9,6 +12,49 @@ namespace coro
 
 namespace detail
 {
+namespace
+{
+// 同一 context 待恢复的 awaiter 链表，awaiter 尚未提交，可以安全地重新链接
+struct awaiter_bucket
+{
+    context*                  ctx{nullptr};
+    event_base::awaiter_base* head{nullptr};
+    event_base::awaiter_base* tail{nullptr};
+
+    inline auto push(event_base::awaiter_base* waiter) noexcept -> void
+    {
+        ctx            = &waiter->m_ctx;
+        waiter->m_next = nullptr;
+        (tail == nullptr ? head : tail->m_next) = waiter;
+        tail = waiter;
+    }
+
+    // 按 kSubmitBatch 分批提交并清空桶
+    auto submit() noexcept -> void
+    {
+        std::array<std::coroutine_handle<>, config::kSubmitBatch> batch;
+        size_t                                                    num = 0;
+        for (auto cur = head; cur != nullptr;)
+        {
+            auto next    = cur->m_next;
+            batch[num++] = cur->m_await_coro;
+            if (num == batch.size())
+            {
+                ctx->submit_tasks({batch.data(), num});
+                num = 0;
+            }
+            cur = next;
+        }
+        if (num > 0)
+        {
+            ctx->submit_tasks({batch.data(), num});
+        }
+        ctx  = nullptr;
+        head = nullptr;
+        tail = nullptr;
+    }
+};
+}; // namespace
 
 auto event_base::awaiter_base::await_ready() noexcept -> bool
 {
@@ -41,14 +87,37 @@ auto event_base::set_state() noexcept -> void // 设置 event，唤醒所有 sus
 }
 
 auto event_base::resume_all_awaiter(awaiter_ptr waiter) noexcept -> void // 唤醒所有 suspend awaiter
-{                                                                        // 以循环的形式遍历链表
-    while (waiter != nullptr)
+{
+    // 单次遍历按 ctx id 分桶，同一 context 的 awaiter 保持原顺序链接到桶内，
+    // 遍历结束后每个桶按批提交，每个 context 每批只唤醒一次
+    std::array<awaiter_bucket, config::kSubmitBucketNum> buckets{};
+    for (auto cur = static_cast<awaiter_base*>(waiter); cur != nullptr;)
     {
-        auto cur = static_cast<awaiter_base*>(waiter);
+        // 协程恢复后 awaiter 可能立即被销毁，因此先读取 next
+        auto next = cur->m_next;
+        if (cur->m_resume != nullptr)
+        {
+            cur->m_resume(cur);
+        }
+        else
+        {
+            auto& bucket = buckets[cur->m_ctx.get_ctx_id() % buckets.size()];
+            if (bucket.ctx != nullptr && bucket.ctx != &cur->m_ctx)
+            {
+                // 两个 context 落入同一个桶，先提交桶中已有的 awaiter
+                bucket.submit();
+            }
+            bucket.push(cur);
+        }
+        cur = next;
+    }
 
-        // 将该 awaiter 绑定的协程投放到其绑定的 context 的任务队列里
-        cur->m_ctx.submit_task(cur->m_await_coro);  // 重新提交任务
-        waiter = cur->m_next;
+    for (auto& bucket : buckets)
+    {
+        if (bucket.ctx != nullptr)
+        {
+            bucket.submit();
+        }
     }
 }
 
@@ -74,6 +143,103 @@ auto event_base::register_awaiter(awaiter_base* waiter) noexcept -> bool // 挂
     return true;
 }
 
+auto event_base::unregister_awaiter(awaiter_base* waiter) noexcept -> bool
+{
+    std::lock_guard<spinlock> lck(m_cancel_lock);
+
+    // 摘下整个链表，过滤掉 waiter 后再挂回去
+    awaiter_ptr old_value = m_state.load(std::memory_order_acquire);
+    do
+    {
+        if (old_value == this)
+        {
+            return false;
+        }
+    } while (!m_state.compare_exchange_weak(old_value, nullptr, std::memory_order_acq_rel));
+
+    awaiter_base* head = nullptr;
+    awaiter_base* tail = nullptr;
+    for (auto cur = static_cast<awaiter_base*>(old_value); cur != nullptr;)
+    {
+        auto next = cur->m_next;
+        if (cur != waiter)
+        {
+            cur->m_next = nullptr;
+            (tail == nullptr ? head : tail->m_next) = cur;
+            tail = cur;
+        }
+        cur = next;
+    }
+    if (head == nullptr)
+    {
+        return true;
+    }
+
+    old_value = m_state.load(std::memory_order_acquire);
+    do
+    {
+        if (old_value == this)
+        {
+            // 摘下期间 event 被 set，剩余的 awaiter 由这里负责恢复
+            resume_all_awaiter(head);
+            return true;
+        }
+        tail->m_next = static_cast<awaiter_base*>(old_value);
+    } while (!m_state.compare_exchange_weak(old_value, head, std::memory_order_acq_rel));
+    return true;
+}
+
+auto event_base::select_node_base::select_register(select_state& state, int index) noexcept -> bool
+{
+    m_select = &state;
+    m_index  = index;
+    if (m_ev.register_awaiter(this))
+    {
+        m_parked = true;
+        return true;
+    }
+    // event 已被 set
+    state.try_win(index);
+    return false;
+}
+
+auto event_base::select_node_base::select_cancel() noexcept -> void
+{
+    if (!m_parked || m_select->winner() == m_index)
+    {
+        return;
+    }
+    if (!m_ev.unregister_awaiter(this))
+    {
+        // set 已取走该节点，等待 set 访问结束后才能释放节点。set 一侧只剩很短的临界区，
+        // 先短暂自旋，若 set 线程被抢占则让出 cpu 避免空转占满时间片
+        for (size_t spin = 0; !m_done.load(std::memory_order_acquire); spin++)
+        {
+            if (spin < config::kSelectCancelSpin)
+            {
+                detail::cpu_relax();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+auto event_base::select_node_base::on_set(awaiter_base* waiter) noexcept -> void
+{
+    auto node  = static_cast<select_node_base*>(waiter);
+    auto state = node->m_select;
+    bool win   = state->try_win(node->m_index);
+    // 设置 m_done 后节点随时可能被释放，不能再访问
+    node->m_done.store(true, std::memory_order_release);
+    if (win && state->complete())
+    {
+        state->resume();
+    }
+}
+
 }; // namespace detail
 
 }; // namespace coro
\ No newline at end of file
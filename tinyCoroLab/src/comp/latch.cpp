@@ -2,5 +2,12 @@
 
 namespace coro
 {
-// TODO[lab4b]: Add codes if you need
+auto latch::count_down() noexcept -> void
+{
+    // 最后一次 count_down 唤醒所有等待者
+    if (m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        m_ev.set_state();
+    }
+}
 };
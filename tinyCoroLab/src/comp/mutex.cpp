@@ -3,5 +3,165 @@
 
 namespace coro
 {
-// TODO[lab4d] : Add codes if you need
-}; // namespace coro
\ No newline at end of file
+auto mutex::mutex_awaiter::await_ready() noexcept -> bool
+{
+    m_ctx.register_wait();
+    return m_mtx.try_lock();
+}
+
+auto mutex::mutex_awaiter::await_suspend(std::coroutine_handle<> handle) noexcept -> bool
+{
+    m_await_coro = handle;
+    return register_lock();
+}
+
+auto mutex::mutex_awaiter::await_resume() noexcept -> void
+{
+    m_ctx.unregister_wait();
+}
+
+auto mutex::mutex_awaiter::register_lock() noexcept -> bool
+{
+    auto state = m_mtx.m_state.load(std::memory_order_acquire);
+    while (true)
+    {
+        if (state == m_mtx.unlocked_state())
+        {
+            // 锁已被释放，直接获取锁，协程不挂起
+            if (m_mtx.m_state.compare_exchange_weak(
+                    state, nullptr, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // 头插法挂载到等待链表
+            m_next = static_cast<mutex_awaiter*>(state);
+            if (m_mtx.m_state.compare_exchange_weak(
+                    state, static_cast<detail::awaiter_ptr>(this), std::memory_order_release, std::memory_order_acquire))
+            {
+                return true;
+            }
+        }
+    }
+}
+
+auto mutex::mutex_awaiter::resume() noexcept -> bool
+{
+    if (m_resume != nullptr)
+    {
+        return m_resume(this);
+    }
+    // 在等待者自己的 context 中恢复，锁的所有权已经直接转交给该等待者
+    m_ctx.submit_task(m_await_coro);
+    return true;
+}
+
+auto mutex::try_lock() noexcept -> bool
+{
+    auto target = unlocked_state();
+    return m_state.compare_exchange_strong(target, nullptr, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+auto mutex::lock() noexcept -> mutex_awaiter
+{
+    return mutex_awaiter(local_context(), *this);
+}
+
+auto mutex::unlock() noexcept -> void
+{
+    assert(m_state.load(std::memory_order_acquire) != unlocked_state());
+
+    while (true)
+    {
+        auto to_resume = m_resume_list_head;
+        if (to_resume == nullptr)
+        {
+            // 没有等待者时直接释放锁
+            detail::awaiter_ptr current = nullptr;
+            if (m_state.compare_exchange_strong(
+                    current, unlocked_state(), std::memory_order_release, std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            // 一次取走所有等待者，锁仍保持为无等待者的加锁状态，链表反转后按 FIFO 顺序转交锁
+            current = m_state.exchange(nullptr, std::memory_order_acq_rel);
+            assert(current != nullptr && current != unlocked_state());
+
+            auto waiter = static_cast<mutex_awaiter*>(current);
+            while (waiter != nullptr)
+            {
+                auto next      = waiter->m_next;
+                waiter->m_next = to_resume;
+                to_resume      = waiter;
+                waiter         = next;
+            }
+        }
+
+        m_resume_list_head = to_resume->m_next;
+        if (to_resume->resume())
+        {
+            return;
+        }
+        // 等待者拒绝了锁（如条件变量的条件不满足而重新等待），继续转交给下一个等待者
+    }
+}
+
+auto mutex::lock_chain(mutex_awaiter* first, mutex_awaiter* last) noexcept -> void
+{
+    // 反转为栈序，栈顶为 last，unlock 再次反转后按 first ... last 的顺序转交锁
+    auto           second = first->m_next;
+    mutex_awaiter* top    = nullptr;
+    for (auto waiter = first; waiter != nullptr;)
+    {
+        auto next      = waiter->m_next;
+        waiter->m_next = top;
+        top            = waiter;
+        waiter         = next;
+    }
+    assert(top == last);
+
+    auto state = m_state.load(std::memory_order_acquire);
+    while (true)
+    {
+        if (state == unlocked_state())
+        {
+            // 锁空闲，first 直接获取锁，其余等待者挂到等待链表
+            if (second != nullptr)
+            {
+                second->m_next = nullptr;
+            }
+            auto rest = second != nullptr ? static_cast<detail::awaiter_ptr>(last) : nullptr;
+            if (m_state.compare_exchange_weak(state, rest, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                if (!first->resume())
+                {
+                    unlock();
+                }
+                return;
+            }
+        }
+        else
+        {
+            if (second != nullptr)
+            {
+                second->m_next = first;
+            }
+            first->m_next = static_cast<mutex_awaiter*>(state);
+            if (m_state.compare_exchange_weak(
+                    state, static_cast<detail::awaiter_ptr>(last), std::memory_order_release, std::memory_order_acquire))
+            {
+                return;
+            }
+        }
+    }
+}
+
+auto mutex::lock_guard() noexcept -> mutex_guard_awaiter
+{
+    return mutex_guard_awaiter(local_context(), *this);
+}
+
+}; // namespace coro
@@ -3,5 +3,19 @@
 
 namespace coro
 {
-// TODO[lab4c] : Add codes if you need
+auto wait_group::add(int count) noexcept -> void
+{
+    auto old_count = m_count.fetch_add(count, std::memory_order_acq_rel);
+    auto new_count = old_count + count;
+    if (old_count > 0 && new_count <= 0)
+    {
+        // 计数归零，取下整个等待链表并恢复所有 awaiter
+        m_ev.set_state();
+    }
+    else if (old_count <= 0 && new_count > 0)
+    {
+        // wait_group 被重新使用，之后的 wait 需要挂起
+        m_ev.reset_state();
+    }
+}
 }; // namespace coro
@@ -24,6 +24,10 @@ auto context::init() noexcept -> void
     // TODO[lab2b]: Add you codes
     linfo.ctx = this;
     m_engine.init();
+#if defined(ENABLE_MEMORY_ALLOC) && defined(ENABLE_MEMORY_PROFILE)
+    // 按 context 统计协程帧的存活数与峰值
+    allocator::memory::frame_profiler::instance().bind_context(m_id);
+#endif
 }
 
 auto context::deinit() noexcept -> void
@@ -37,13 +41,13 @@ auto context::start() noexcept -> void
 {
     // TODO[lab2b]: Add you codes
     m_job = make_unique<jthread>(
-        [this](stop_token token)
+        [this, token = m_stop_source.get_token()]()
         {
             this->init();
             // 如果外部没有注入 stop_cb，那么自行为其添加逻辑
             if (!(this->m_stop_cb))
             {
-                m_stop_cb = [&]() { m_job->request_stop(); };
+                m_stop_cb = [&]() { m_stop_source.request_stop(); };
             }
             this->run(token);
             this->deinit();
@@ -53,7 +57,7 @@ auto context::start() noexcept -> void
 auto context::notify_stop() noexcept -> void
 {
     // TODO[lab2b]: Add you codes
-    m_job->request_stop();
+    m_stop_source.request_stop();
     m_engine.wake_up(); // 唤醒engin处理任务
 }
 
@@ -63,6 +67,11 @@ auto context::submit_task(std::coroutine_handle<> handle) noexcept -> void
     m_engine.submit_task(handle);
 }
 
+auto context::submit_tasks(std::span<std::coroutine_handle<>> handles) noexcept -> void
+{
+    m_engine.submit_tasks(handles);
+}
+
 auto context::register_wait(int register_cnt) noexcept -> void
 {
     // TODO[lab2b]: Add you codes
@@ -85,12 +94,24 @@ auto context::run(stop_token token) noexcept -> void
         // 处理engine所有任务
         process_work();
 
+        // 本地无就绪任务，在阻塞于 poll_work 之前尝试从其他 context 窃取任务
+        // 窃取成功后 engine 处于 ready 状态，poll_work 不会阻塞，还有 IO 在途时顺便处理已完成的 cqe
+        if (m_steal_cb && !m_engine.ready() && m_steal_cb() && m_engine.empty_io())
+        {
+            continue;
+        }
+
         if (empty_wait_task())
         {
             if (!m_engine.ready())
             {
                 // 此处表明 contetx 已执行完所有任务，那么调用停止逻辑
                 m_stop_cb();
+                // stop_cb 可能已请求停止本 context，提交任务不再必然写 eventfd，不能再阻塞于 poll_work
+                if (token.stop_requested())
+                {
+                    continue;
+                }
             }
             else
             {
@@ -106,6 +127,11 @@ auto context::run(stop_token token) noexcept -> void
 auto context::process_work() noexcept -> void
 {
     auto num = m_engine.num_task_schedule();
+    // 积压了多个任务，唤醒一个空闲的 context 来窃取
+    if (m_notify_cb && num > 1)
+    {
+        m_notify_cb();
+    }
     for (int i = 0; i < num; ++i)
     {
         m_engine.exec_one_task();
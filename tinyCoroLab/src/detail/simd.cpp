@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "config.h"
+#include "coro/attribute.hpp"
+#include "coro/detail/simd.hpp"
+#include "coro/utils.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #include <immintrin.h>
+    #define CORO_SIMD_X86
+    #define CORO_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace coro::detail::simd
+{
+namespace
+{
+using find_head_end_type = auto (*)(const char*, const char*) noexcept -> const char*;
+using find_any_type      = auto (*)(const char*, const char*, char, char) noexcept -> const char*;
+using to_lower_type      = auto (*)(const char*, size_t, char*) noexcept -> void;
+using iequal_type        = auto (*)(const char*, const char*, size_t) noexcept -> bool;
+
+struct dispatch_table
+{
+    simd_level         lv;
+    find_head_end_type find_head_end;
+    find_any_type      find_any;
+    to_lower_type      to_lower;
+    iequal_type        iequal;
+};
+
+// ============================== scalar ==============================
+
+auto find_head_end_scalar(const char* first, const char* last) noexcept -> const char*
+{
+    // 以 '\n' 为锚点查找，命中后再回看前三个字节
+    while (last - first >= 4)
+    {
+        auto lf = static_cast<const char*>(std::memchr(first + 3, '\n', last - first - 3));
+        if (lf == nullptr)
+        {
+            return nullptr;
+        }
+        if (lf[-1] == '\r' && lf[-2] == '\n' && lf[-3] == '\r')
+        {
+            return lf + 1;
+        }
+        first = lf - 2;
+    }
+    return nullptr;
+}
+
+auto find_any_scalar(const char* first, const char* last, char a, char b) noexcept -> const char*
+{
+    for (; first != last; ++first)
+    {
+        if (*first == a || *first == b)
+        {
+            return first;
+        }
+    }
+    return last;
+}
+
+auto to_lower_scalar(const char* src, size_t len, char* dst) noexcept -> void
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        dst[i] = static_cast<char>(utils::to_lower(src[i]));
+    }
+}
+
+auto iequal_scalar(const char* a, const char* b, size_t len) noexcept -> bool
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        if (utils::to_lower(a[i]) != utils::to_lower(b[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr dispatch_table kScalarTable{
+    simd_level::scalar, &find_head_end_scalar, &find_any_scalar, &to_lower_scalar, &iequal_scalar};
+
+#ifdef CORO_SIMD_X86
+// ============================== sse4.2 ==============================
+
+// 与 utils::to_lower 的表一致：'A'-'Z' 以及 0xC0-0xDE（除 0xD7）加 0x20，这些字节的 0x20 位均为 0
+CORO_TARGET("sse4.2") inline auto lower_sse(__m128i v) noexcept -> __m128i
+{
+    auto t1     = _mm_sub_epi8(v, _mm_set1_epi8('A'));
+    auto ascii  = _mm_cmpeq_epi8(_mm_min_epu8(t1, _mm_set1_epi8(25)), t1);
+    auto t2     = _mm_sub_epi8(v, _mm_set1_epi8(static_cast<char>(0xC0)));
+    auto latin  = _mm_cmpeq_epi8(_mm_min_epu8(t2, _mm_set1_epi8(30)), t2);
+    latin       = _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(0xD7))), latin);
+    auto is_upr = _mm_or_si128(ascii, latin);
+    return _mm_or_si128(v, _mm_and_si128(is_upr, _mm_set1_epi8(0x20)));
+}
+
+CORO_TARGET("sse4.2") auto find_head_end_sse42(const char* first, const char* last) noexcept -> const char*
+{
+    const auto cr = _mm_set1_epi8('\r');
+    const auto lf = _mm_set1_epi8('\n');
+    // 四次错位加载，第 i 位为 1 表示从 i 开始是 "\r\n\r\n"
+    while (last - first >= 16 + 3)
+    {
+        auto m0   = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)), cr);
+        auto m1   = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 1)), lf);
+        auto m2   = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 2)), cr);
+        auto m3   = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 3)), lf);
+        auto mask = _mm_movemask_epi8(_mm_and_si128(_mm_and_si128(m0, m1), _mm_and_si128(m2, m3)));
+        if (mask != 0)
+        {
+            return first + __builtin_ctz(mask) + 4;
+        }
+        first += 16;
+    }
+    return find_head_end_scalar(first, last);
+}
+
+CORO_TARGET("sse4.2") auto find_any_sse42(const char* first, const char* last, char a, char b) noexcept -> const char*
+{
+    const auto set = _mm_setr_epi8(a, b, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    while (last - first >= 16)
+    {
+        auto v   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        auto idx = _mm_cmpestri(set, 2, v, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT);
+        if (idx != 16)
+        {
+            return first + idx;
+        }
+        first += 16;
+    }
+    return find_any_scalar(first, last, a, b);
+}
+
+CORO_TARGET("sse4.2") auto to_lower_sse42(const char* src, size_t len, char* dst) noexcept -> void
+{
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), lower_sse(v));
+    }
+    to_lower_scalar(src + i, len - i, dst + i);
+}
+
+CORO_TARGET("sse4.2") auto iequal_sse42(const char* a, const char* b, size_t len) noexcept -> bool
+{
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        auto va = lower_sse(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        auto vb = lower_sse(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xFFFF)
+        {
+            return false;
+        }
+    }
+    return iequal_scalar(a + i, b + i, len - i);
+}
+
+constexpr dispatch_table kSse42Table{
+    simd_level::sse42, &find_head_end_sse42, &find_any_sse42, &to_lower_sse42, &iequal_sse42};
+
+// =============================== avx2 ===============================
+
+CORO_TARGET("avx2") inline auto lower_avx2(__m256i v) noexcept -> __m256i
+{
+    auto t1     = _mm256_sub_epi8(v, _mm256_set1_epi8('A'));
+    auto ascii  = _mm256_cmpeq_epi8(_mm256_min_epu8(t1, _mm256_set1_epi8(25)), t1);
+    auto t2     = _mm256_sub_epi8(v, _mm256_set1_epi8(static_cast<char>(0xC0)));
+    auto latin  = _mm256_cmpeq_epi8(_mm256_min_epu8(t2, _mm256_set1_epi8(30)), t2);
+    latin       = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(static_cast<char>(0xD7))), latin);
+    auto is_upr = _mm256_or_si256(ascii, latin);
+    return _mm256_or_si256(v, _mm256_and_si256(is_upr, _mm256_set1_epi8(0x20)));
+}
+
+CORO_TARGET("avx2") auto find_head_end_avx2(const char* first, const char* last) noexcept -> const char*
+{
+    const auto cr = _mm256_set1_epi8('\r');
+    const auto lf = _mm256_set1_epi8('\n');
+    while (last - first >= 32 + 3)
+    {
+        auto m0   = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)), cr);
+        auto m1   = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + 1)), lf);
+        auto m2   = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + 2)), cr);
+        auto m3   = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + 3)), lf);
+        auto mask = static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(m0, m1), _mm256_and_si256(m2, m3))));
+        if (mask != 0)
+        {
+            return first + __builtin_ctz(mask) + 4;
+        }
+        first += 32;
+    }
+    return find_head_end_sse42(first, last);
+}
+
+CORO_TARGET("avx2") auto find_any_avx2(const char* first, const char* last, char a, char b) noexcept -> const char*
+{
+    const auto va = _mm256_set1_epi8(a);
+    const auto vb = _mm256_set1_epi8(b);
+    while (last - first >= 32)
+    {
+        auto v    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        auto mask = static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb))));
+        if (mask != 0)
+        {
+            return first + __builtin_ctz(mask);
+        }
+        first += 32;
+    }
+    return find_any_sse42(first, last, a, b);
+}
+
+CORO_TARGET("avx2") auto to_lower_avx2(const char* src, size_t len, char* dst) noexcept -> void
+{
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32)
+    {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), lower_avx2(v));
+    }
+    to_lower_sse42(src + i, len - i, dst + i);
+}
+
+CORO_TARGET("avx2") auto iequal_avx2(const char* a, const char* b, size_t len) noexcept -> bool
+{
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32)
+    {
+        auto va = lower_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+        auto vb = lower_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        if (static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb))) != 0xFFFFFFFFu)
+        {
+            return false;
+        }
+    }
+    return iequal_sse42(a + i, b + i, len - i);
+}
+
+constexpr dispatch_table kAvx2Table{
+    simd_level::avx2, &find_head_end_avx2, &find_any_avx2, &to_lower_avx2, &iequal_avx2};
+#endif // CORO_SIMD_X86
+
+auto detect() noexcept -> simd_level
+{
+#ifdef CORO_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return simd_level::avx2;
+    }
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        return simd_level::sse42;
+    }
+#endif
+    return simd_level::scalar;
+}
+
+// 启动前使用标量实现，静态初始化阶段切换到 cpu 支持的最高级别
+std::atomic<const dispatch_table*> g_table{&kScalarTable};
+
+[[CORO_MAYBE_UNUSED]] const simd_level g_init_level = set_level(config::kSimdMaxLevel);
+
+inline auto table() noexcept -> const dispatch_table&
+{
+    return *g_table.load(std::memory_order_relaxed);
+}
+}; // namespace
+
+auto level() noexcept -> simd_level
+{
+    return table().lv;
+}
+
+auto set_level(simd_level lv) noexcept -> simd_level
+{
+    lv = std::min({lv, detect(), config::kSimdMaxLevel});
+    switch (lv)
+    {
+#ifdef CORO_SIMD_X86
+        case simd_level::avx2:
+            g_table.store(&kAvx2Table, std::memory_order_relaxed);
+            break;
+        case simd_level::sse42:
+            g_table.store(&kSse42Table, std::memory_order_relaxed);
+            break;
+#endif
+        default:
+            g_table.store(&kScalarTable, std::memory_order_relaxed);
+            break;
+    }
+    return table().lv;
+}
+
+auto find_head_end(const char* first, const char* last) noexcept -> const char*
+{
+    return table().find_head_end(first, last);
+}
+
+auto find_any(const char* first, const char* last, char a, char b) noexcept -> const char*
+{
+    return table().find_any(first, last, a, b);
+}
+
+auto to_lower(const char* src, size_t len, char* dst) noexcept -> void
+{
+    table().to_lower(src, len, dst);
+}
+
+auto iequal(const char* a, const char* b, size_t len) noexcept -> bool
+{
+    return table().iequal(a, b, len);
+}
+
+}; // namespace coro::detail::simd
@@ -16,6 +16,10 @@ auto engine::init() noexcept -> void
     linfo.egn            = this;
     m_num_io_wait_submit = 0;
     m_num_io_running     = 0;
+    m_num_lifo_polls     = 0;
+    m_num_schedule       = 0;
+    m_sleeping.store(false, memory_order_relaxed);
+    m_efd_armed = false;
     m_upxy.init(config::kEntryLength);
 }
 
@@ -27,12 +31,19 @@ auto engine::deinit() noexcept -> void
     m_num_io_running     = 0;
     mpmc_queue<coroutine_handle<>> task_queue;
     m_task_queue.swap(task_queue);
+    m_local_queue.reset();
+    m_lifo_slot.store(nullptr, memory_order_relaxed);
+    queue<coroutine_handle<>> overflow_queue;
+    m_overflow_queue.swap(overflow_queue);
+    m_num_overflow.store(0, memory_order_relaxed);
+    m_deferred_io.clear();
 }
 
 auto engine::ready() noexcept -> bool
 {
     // TODO[lab2a]: Add you codes
-    return m_task_queue.was_size() > 0;
+    return m_lifo_slot.load(memory_order_relaxed) != nullptr || !m_local_queue.was_empty() ||
+           m_task_queue.was_size() > 0 || m_num_overflow.load(memory_order_relaxed) > 0;
 }
 
 auto engine::get_free_urs() noexcept -> ursptr
@@ -44,14 +55,52 @@ auto engine::get_free_urs() noexcept -> ursptr
 auto engine::num_task_schedule() noexcept -> size_t
 {
     // TODO[lab2a]: Add you codes
-    return m_task_queue.was_size();
+    return (m_lifo_slot.load(memory_order_relaxed) != nullptr ? 1 : 0) + m_local_queue.was_size() +
+           m_task_queue.was_size() + m_num_overflow.load(memory_order_relaxed);
 }
 
 auto engine::schedule() noexcept -> coroutine_handle<>
 {
     // TODO[lab2a]: Add you codes
-    auto coro = m_task_queue.pop();
-    assert(bool(coro));
+    // 任务可能已被其他 engine 窃取，所以不能阻塞式 pop
+    coroutine_handle<> coro{nullptr};
+
+    // 定期优先检查 task queue，防止其他线程提交的任务被本线程提交的任务饿死
+    if (++m_num_schedule % config::kGlobalQueInterval == 0 && m_task_queue.try_pop(coro))
+    {
+        return coro;
+    }
+
+    // lifo slot 只有本线程访问，load + store 即可
+    if (m_num_lifo_polls < config::kMaxLifoPolls)
+    {
+        coro = m_lifo_slot.load(memory_order_relaxed);
+        if (coro)
+        {
+            m_lifo_slot.store(nullptr, memory_order_relaxed);
+            ++m_num_lifo_polls;
+            return coro;
+        }
+    }
+
+    m_num_lifo_polls = 0;
+    if (m_local_queue.try_pop(coro) || m_task_queue.try_pop(coro))
+    {
+        return coro;
+    }
+
+    // 溢出队列只有本线程访问
+    if (!m_overflow_queue.empty())
+    {
+        coro = m_overflow_queue.front();
+        m_overflow_queue.pop();
+        m_num_overflow.store(m_overflow_queue.size(), memory_order_relaxed);
+        return coro;
+    }
+
+    // 其他队列为空，lifo slot 里的任务可以继续执行
+    coro = m_lifo_slot.load(memory_order_relaxed);
+    m_lifo_slot.store(nullptr, memory_order_relaxed);
     return coro;
 }
 
@@ -59,14 +108,79 @@ auto engine::submit_task(coroutine_handle<> handle) noexcept -> void
 {
     // TODO[lab2a]: Add you codes
     assert(handle != nullptr && "engine get nullptr task handle");
+    if (linfo.egn == this)
+    {
+        // 本线程提交（如 io 完成回调），放入 lifo slot，原任务挤入本地队列。
+        // 本线程正在运行，不需要写 eventfd 唤醒
+        auto prev = m_lifo_slot.load(memory_order_relaxed);
+        m_lifo_slot.store(handle, memory_order_relaxed);
+        if (prev)
+        {
+            push_local(prev);
+        }
+        return;
+    }
+
     m_task_queue.push(handle);      // atomic_queue 第三方库操作是线程安全的
-    // 来了新任务，向 eventfd 写入 task_flag
-    wake_up();
+    // 来了新任务，只有工作线程已经（或即将）阻塞时才向 eventfd 写入 task_flag，
+    // 与 poll_submit 中 m_sleeping 的发布构成 Dekker 式同步，不会丢失唤醒。
+    // exchange 保证一次睡眠只有一个提交者写 eventfd
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load(memory_order_relaxed) && m_sleeping.exchange(false, std::memory_order_acq_rel))
+    {
+        wake_up();
+    }
+}
+
+auto engine::submit_tasks(std::span<coroutine_handle<>> handles) noexcept -> void
+{
+    if (handles.empty())
+    {
+        return;
+    }
+    if (linfo.egn == this)
+    {
+        // 本线程批量提交，保持顺序放入本地队列，无需唤醒
+        for (auto handle : handles)
+        {
+            assert(handle != nullptr && "engine get nullptr task handle");
+            push_local(handle);
+        }
+        return;
+    }
+
+    for (auto handle : handles)
+    {
+        assert(handle != nullptr && "engine get nullptr task handle");
+        m_task_queue.push(handle);
+    }
+    // 整批入队后只做一次唤醒检查，同 submit_task
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load(memory_order_relaxed) && m_sleeping.exchange(false, std::memory_order_acq_rel))
+    {
+        wake_up();
+    }
+}
+
+auto engine::push_local(coroutine_handle<> handle) noexcept -> void
+{
+    if (m_local_queue.try_push(handle) || m_task_queue.try_push(handle))
+    {
+        return;
+    }
+    // 队列均已满，放入溢出队列。调用方可能正处于 mutex::unlock、event 唤醒或 cqe 回调中，
+    // 在这里直接执行任务会造成协程重入
+    m_overflow_queue.push(handle);
+    m_num_overflow.store(m_overflow_queue.size(), memory_order_relaxed);
 }
 
 auto engine::exec_one_task() noexcept -> void
 {
     auto coro = schedule();
+    if (!coro)
+    {
+        return;
+    }
     coro.resume();
     if (coro.done())
     {
@@ -91,22 +205,52 @@ auto engine::handle_cqe_entry(urcptr cqe) noexcept -> void
         接受连接（accept）	新 socket 的文件描述符	负错误码（如 -ECONNABORTED）
         定时器（timeout）	超时前完成的任务数	-ETIME（超时）或 -EINVAL
     
+    flags
+        完成事件的附加信息，如 IORING_CQE_F_BUFFER 置位时高 16 位为内核选择的 buffer id
     */
+    data->flags = cqe->flags;
     data->cb(data, cqe->res);
 }
 
 auto engine::poll_submit() noexcept -> void
 {
     // TODO[lab2a]: Add you codes
+    if constexpr (config::kEngineWaitMode == engine_wait_mode::uring_wait)
+    {
+        poll_submit_and_wait();
+        return;
+    }
+
     // 对 I/O 的提交
     do_io_submit();
 
+    // 刚提交完 sqe，推迟的 IO 可以取到空闲 sqe，重新准备后立即提交
+    bool deferred = !retry_deferred_io();
+    do_io_submit();
+
     // 等待 I/O 执行
     // 工作线程在 无任何任务 的情况下 利用阻塞在 eventfd 读操作上来让出执行权防止 CPU 空转。
-    auto cnt = m_upxy.wait_eventfd();
-    if (!wake_by_cqe(cnt))
+    // 本线程提交的任务不会写 eventfd，所以还有任务或推迟的 IO 时不能阻塞，直接检查 cqe。
+    // 上一轮 cqe 超过 kQueCap 时剩余的 cqe 对应的 eventfd 计数已被读走，也不能阻塞
+    if (!ready() && !deferred && !m_upxy.peek_uring())
     {
-        return;
+        // 先发布 sleeping 再检查一次任务队列，提交者先入队再检查 sleeping，
+        // 两者至少有一方能看到对方的写入
+        m_sleeping.store(true, memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready())
+        {
+            auto cnt = m_upxy.wait_eventfd();
+            m_sleeping.store(false, memory_order_relaxed);
+            if (!wake_by_cqe(cnt))
+            {
+                return;
+            }
+        }
+        else
+        {
+            m_sleeping.store(false, memory_order_relaxed);
+        }
     }
 
     // 取出 I/O
@@ -114,20 +258,97 @@ auto engine::poll_submit() noexcept -> void
 
     if (num != 0)
     {
+        // multishot 请求的 cqe 带有 IORING_CQE_F_MORE 时请求仍未结束，不计入完成数
+        int num_more = 0;
         for (int i = 0; i < num; i++)
         {
+            num_more += (m_urc[i]->flags & IORING_CQE_F_MORE) ? 1 : 0;
             handle_cqe_entry(m_urc[i]);
         }
         m_upxy.cq_advance(num);
-        m_num_io_running -= num;
+        m_num_io_running -= (num - num_more);
     }
 }
 
+auto engine::poll_submit_and_wait() noexcept -> void
+{
+    // 挂起一个 eventfd 读请求，其他线程写 eventfd 时该请求完成，从而唤醒阻塞在 io_uring_enter 的本线程
+    if (!m_efd_armed)
+    {
+        auto sqe = m_upxy.get_free_sqe();
+        if (sqe != nullptr)
+        {
+            m_upxy.prep_read_eventfd(sqe, &m_efd_buf);
+            io_uring_sqe_set_data(sqe, this);
+            m_efd_armed = true;
+        }
+    }
+
+    bool deferred = !retry_deferred_io();
+
+    bool sleep = false;
+    if (!ready() && !deferred)
+    {
+        m_sleeping.store(true, memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        sleep = !ready();
+    }
+
+    // 没有待提交的 sqe 且无需等待时，liburing 不会陷入内核。
+    // 没有挂起 eventfd 读请求时不能阻塞在 io_uring_enter，否则可能无法被唤醒
+    [[CORO_MAYBE_UNUSED]] auto _ = m_upxy.submit_and_wait(sleep && m_efd_armed ? 1 : 0);
+    if (sleep && !m_efd_armed)
+    {
+        // sq 已满无法挂起 eventfd 读请求，sqe 已在上面提交，退回到同时等待 eventfd 与 cqe，避免空转
+        m_upxy.wait_eventfd_or_cqe();
+    }
+    m_sleeping.store(false, memory_order_relaxed);
+    m_num_io_running += m_num_io_wait_submit;
+    m_num_io_wait_submit = 0;
+
+    int num = m_upxy.peek_batch_cqe(m_urc.data(), config::kQueCap);
+    if (num == 0)
+    {
+        return;
+    }
+
+    int num_wake = 0;
+    int num_more = 0;
+    for (int i = 0; i < num; i++)
+    {
+        if (io_uring_cqe_get_data(m_urc[i]) == this)
+        {
+            // eventfd 读请求完成，下次 poll 时重新挂起
+            m_efd_armed = false;
+            ++num_wake;
+            continue;
+        }
+        num_more += (m_urc[i]->flags & IORING_CQE_F_MORE) ? 1 : 0;
+        handle_cqe_entry(m_urc[i]);
+    }
+    m_upxy.cq_advance(num);
+    m_num_io_running -= (num - num_wake - num_more);
+}
+
 auto engine::wake_up(uint64_t val) noexcept -> void
 {
     m_upxy.write_eventfd(val);
 }
 
+auto engine::steal_from(engine& victim, size_t num) noexcept -> size_t
+{
+    size_t             cnt = 0;
+    coroutine_handle<> handle;
+    // 窃取的任务直接放入本地队列，调用方是本 engine 的工作线程，无需写 eventfd 唤醒。
+    // victim 的 lifo slot 不会被窃取
+    while (cnt < num && (victim.m_task_queue.try_pop(handle) || victim.m_local_queue.try_pop(handle)))
+    {
+        push_local(handle);
+        ++cnt;
+    }
+    return cnt;
+}
+
 auto engine::add_io_submit() noexcept -> void
 {
     // TODO[lab2a]: Add you codes
@@ -137,7 +358,28 @@ auto engine::add_io_submit() noexcept -> void
 auto engine::empty_io() noexcept -> bool
 {
     // TODO[lab2a]: Add you codes
-    return m_num_io_wait_submit == 0 && m_num_io_running == 0;
+    return m_num_io_wait_submit == 0 && m_num_io_running == 0 && m_deferred_io.empty();
+}
+
+auto engine::defer_io(io::detail::io_info* info, io::detail::cb_type retry) noexcept -> void
+{
+    m_deferred_io.emplace_back(info, retry);
+}
+
+auto engine::retry_deferred_io() noexcept -> bool
+{
+    if (m_deferred_io.empty()) [[likely]]
+    {
+        return true;
+    }
+    // 重试时可能再次推迟，先取出当前列表
+    auto deferred = std::move(m_deferred_io);
+    m_deferred_io.clear();
+    for (auto [info, retry] : deferred)
+    {
+        retry(info, 0);
+    }
+    return m_deferred_io.empty();
 }
 
 auto engine::do_io_submit() noexcept -> void
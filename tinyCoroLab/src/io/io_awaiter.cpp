@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cerrno>
+#include <climits>
 #include <optional>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -72,6 +75,29 @@ auto tcp_accept_awaiter::callback(io_info* data, int res) noexcept -> void
     submit_to_context(data->handle);
 }
 
+tcp_accept_stream::tcp_accept_stream(int listenfd, int io_flag, int sqe_flag) noexcept
+    : multishot_stream(listenfd, io_flag, sqe_flag, &tcp_accept_stream::prep, &tcp_accept_stream::drop)
+{
+    m_state->type = io_type::tcp_accept_multishot;
+}
+
+auto tcp_accept_stream::prep(uring::ursptr sqe, detail::multishot_state* state) noexcept -> void
+{
+    io_uring_sqe_set_flags(sqe, state->sqe_flag);
+    io_uring_prep_multishot_accept(sqe, state->fd, nullptr, nullptr, state->io_flag);
+}
+
+auto tcp_accept_stream::drop(
+    [[CORO_MAYBE_UNUSED]] detail::multishot_state* state, int32_t res, [[CORO_MAYBE_UNUSED]] uint32_t flags) noexcept
+    -> void
+{
+    // stream 销毁时还未取出的连接直接关闭
+    if (res >= 0)
+    {
+        ::close(res);
+    }
+}
+
 tcp_read_awaiter::tcp_read_awaiter(int sockfd, char* buf, size_t len, int io_flag, int sqe_flag) noexcept
 {
     m_info.type = io_type::tcp_read;
@@ -89,6 +115,83 @@ auto tcp_read_awaiter::callback(io_info* data, int res) noexcept -> void
     submit_to_context(data->handle);
 }
 
+tcp_recv_pooled_awaiter::tcp_recv_pooled_awaiter(int sockfd, int io_flag, int sqe_flag) noexcept
+    : m_upxy(&local_engine().get_uring())
+{
+    m_info.type  = io_type::tcp_read_pooled;
+    m_info.cb    = &tcp_recv_pooled_awaiter::callback;
+    m_info.flags = 0;
+
+    // buffer ring 在首次使用时注册，注册失败时内核会以 -ENOBUFS 完成该请求
+    if (m_upxy->init_buf_ring())
+    {
+        m_upxy->drain_remote_buffers();
+    }
+
+    io_uring_sqe_set_flags(m_urs, sqe_flag | IOSQE_BUFFER_SELECT);
+    io_uring_prep_recv(m_urs, sockfd, nullptr, config::kBufRingBufSize, io_flag);
+    m_urs->buf_group = config::kBufRingGroupId;
+    io_uring_sqe_set_data(m_urs, &m_info);
+    local_engine().add_io_submit();
+}
+
+auto tcp_recv_pooled_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    data->result = res;
+    submit_to_context(data->handle);
+}
+
+auto tcp_recv_pooled_awaiter::await_resume() noexcept -> pooled_buffer
+{
+    // 只要 cqe 携带 buffer id，该 buffer 就已被内核取出，需要交给 pooled_buffer 归还
+    if (m_info.flags & IORING_CQE_F_BUFFER)
+    {
+        return pooled_buffer(m_upxy, m_info.result, m_info.flags >> IORING_CQE_BUFFER_SHIFT);
+    }
+    return pooled_buffer(nullptr, m_info.result, 0);
+}
+
+tcp_recv_stream::tcp_recv_stream(int sockfd, int io_flag, int sqe_flag) noexcept
+    : multishot_stream(sockfd, io_flag, sqe_flag, &tcp_recv_stream::prep, &tcp_recv_stream::drop)
+{
+    m_state->type         = io_type::tcp_read_multishot;
+    m_state->extra        = CASTPTR(&local_engine().get_uring());
+    m_state->rearm_nobufs = true;
+}
+
+auto tcp_recv_stream::prep(uring::ursptr sqe, detail::multishot_state* state) noexcept -> void
+{
+    // 每次挂起 multishot 请求前归还其他线程释放的 buffer，buffer ring 为空会导致内核终止该请求
+    auto upxy = reinterpret_cast<uring::uring_proxy*>(state->extra);
+    if (upxy->init_buf_ring())
+    {
+        upxy->drain_remote_buffers();
+    }
+
+    io_uring_sqe_set_flags(sqe, state->sqe_flag | IOSQE_BUFFER_SELECT);
+    io_uring_prep_recv_multishot(sqe, state->fd, nullptr, 0, state->io_flag);
+    sqe->buf_group = config::kBufRingGroupId;
+}
+
+auto tcp_recv_stream::drop(detail::multishot_state* state, [[CORO_MAYBE_UNUSED]] int32_t res, uint32_t flags) noexcept
+    -> void
+{
+    if (flags & IORING_CQE_F_BUFFER)
+    {
+        reinterpret_cast<uring::uring_proxy*>(state->extra)->recycle_buffer(flags >> IORING_CQE_BUFFER_SHIFT);
+    }
+}
+
+auto tcp_recv_stream::next_awaiter::await_resume() noexcept -> pooled_buffer
+{
+    auto [res, flags] = detail::multishot_stream::next_awaiter::await_resume();
+    if (flags & IORING_CQE_F_BUFFER)
+    {
+        return pooled_buffer(upxy, res, flags >> IORING_CQE_BUFFER_SHIFT);
+    }
+    return pooled_buffer(nullptr, res, 0);
+}
+
 tcp_write_awaiter::tcp_write_awaiter(int sockfd, char* buf, size_t len, int io_flag, int sqe_flag) noexcept
 {
     m_info.type = io_type::tcp_write;
@@ -106,6 +209,91 @@ auto tcp_write_awaiter::callback(io_info* data, int res) noexcept -> void
     submit_to_context(data->handle);
 }
 
+tcp_writev_awaiter::tcp_writev_awaiter(int sockfd, std::span<iovec> iov, int sqe_flag) noexcept
+    : tcp_writev_awaiter(sockfd, iov, 0, sqe_flag, io_type::tcp_writev)
+{
+}
+
+tcp_writev_awaiter::tcp_writev_awaiter(
+    int sockfd, std::span<iovec> iov, int io_flag, int sqe_flag, io_type type) noexcept
+    : m_sockfd(sockfd),
+      m_io_flag(io_flag),
+      m_sqe_flag(sqe_flag),
+      m_iov(iov.data()),
+      m_iovcnt(iov.size())
+{
+    m_info.type = type;
+    m_info.cb   = &tcp_writev_awaiter::callback;
+    m_info.data = CASTPTR(this);
+
+    prep(m_urs);
+    local_engine().add_io_submit();
+}
+
+auto tcp_writev_awaiter::prep(uring::ursptr urs) noexcept -> void
+{
+    // 单个 sqe 最多携带 IOV_MAX 个 iovec，其余的在短写后继续提交
+    auto cnt = std::min<size_t>(m_iovcnt, IOV_MAX);
+    io_uring_sqe_set_flags(urs, m_sqe_flag);
+    if (m_info.type == io_type::tcp_sendmsg)
+    {
+        m_msg.msg_iov    = m_iov;
+        m_msg.msg_iovlen = cnt;
+        io_uring_prep_sendmsg(urs, m_sockfd, &m_msg, m_io_flag);
+    }
+    else
+    {
+        // socket 不支持偏移，offset 固定为 0
+        io_uring_prep_writev(urs, m_sockfd, m_iov, cnt, 0);
+    }
+    io_uring_sqe_set_data(urs, &m_info);
+}
+
+auto tcp_writev_awaiter::advance(size_t n) noexcept -> bool
+{
+    while (m_iovcnt > 0)
+    {
+        if (n < m_iov->iov_len)
+        {
+            m_iov->iov_base = static_cast<char*>(m_iov->iov_base) + n;
+            m_iov->iov_len -= n;
+            return false;
+        }
+        n -= m_iov->iov_len;
+        m_iov++;
+        m_iovcnt--;
+    }
+    return true;
+}
+
+auto tcp_writev_awaiter::callback(io_info* data, int res) noexcept -> void
+{
+    auto awaiter = reinterpret_cast<tcp_writev_awaiter*>(data->data);
+    if (res >= 0)
+    {
+        // 返回 0 说明本次提交的 iovec 长度均为 0 或是推迟后的重试，跳过长度为 0 的 iovec 后继续
+        awaiter->m_written += res;
+        // 短写时在本线程继续提交剩余部分，协程只在全部发送完成或出错时恢复
+        if (!awaiter->advance(res))
+        {
+            auto urs = local_engine().get_free_urs();
+            if (urs != nullptr)
+            {
+                awaiter->prep(urs);
+                local_engine().add_io_submit();
+            }
+            else
+            {
+                // sqe 耗尽时推迟到下一次 poll 提交完 sqe 后再续写，重试时 res 为 0
+                local_engine().defer_io(data, &tcp_writev_awaiter::callback);
+            }
+            return;
+        }
+    }
+    data->result = res < 0 ? res : awaiter->m_written;
+    submit_to_context(data->handle);
+}
+
 tcp_close_awaiter::tcp_close_awaiter(int sockfd) noexcept
 {
     m_info.type = io_type::tcp_close;
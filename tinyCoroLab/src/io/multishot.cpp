@@ -0,0 +1,160 @@
+#include "coro/io/multishot.hpp"
+#include "coro/scheduler.hpp"
+
+namespace coro::io::detail
+{
+using ::coro::detail::local_engine;
+
+auto multishot_state::callback(io_info* data, int res) noexcept -> void
+{
+    auto state = static_cast<multishot_state*>(data);
+    // 没有 IORING_CQE_F_MORE 说明内核已终止该 multishot 请求
+    if (!(state->flags & IORING_CQE_F_MORE))
+    {
+        state->armed = false;
+        state->pending--;
+    }
+
+    if (state->detached)
+    {
+        if (state->drop != nullptr)
+        {
+            state->drop(state, res, state->flags);
+        }
+        state->try_destroy();
+        return;
+    }
+
+    // buffer ring 耗尽不是连接错误，有协程等待时立即重新挂起（prep 会先归还其他线程释放的 buffer），
+    // 否则等下一次 next() 时再挂起
+    if (res == -ENOBUFS && state->rearm_nobufs && !state->armed)
+    {
+        if (state->handle == nullptr || state->arm())
+        {
+            return;
+        }
+        res = -EBUSY;
+    }
+
+    state->cqes.emplace_back(res, state->flags);
+    if (state->handle != nullptr)
+    {
+        submit_to_context(std::exchange(state->handle, nullptr));
+    }
+}
+
+auto multishot_state::cancel_callback(io_info* data, [[CORO_MAYBE_UNUSED]] int res) noexcept -> void
+{
+    auto state = static_cast<multishot_cancel_info*>(data)->state;
+    state->pending--;
+    state->try_destroy();
+}
+
+auto multishot_state::cancel_retry(io_info* data, [[CORO_MAYBE_UNUSED]] int res) noexcept -> void
+{
+    auto state = static_cast<multishot_cancel_info*>(data)->state;
+    state->pending--;
+    // 推迟期间 multishot 请求可能已被内核终止，此时无需再取消
+    if (state->armed)
+    {
+        state->cancel();
+    }
+    state->try_destroy();
+}
+
+auto multishot_state::cancel() noexcept -> void
+{
+    // 推迟的取消请求同样计入 pending，保证重试前 state 不会被释放
+    pending++;
+    auto sqe = local_engine().get_free_urs();
+    if (sqe == nullptr)
+    {
+        local_engine().defer_io(&cancel_info, &multishot_state::cancel_retry);
+        return;
+    }
+    io_uring_prep_cancel(sqe, static_cast<io_info*>(this), 0);
+    io_uring_sqe_set_data(sqe, static_cast<io_info*>(&cancel_info));
+    local_engine().add_io_submit();
+}
+
+auto multishot_state::try_destroy() noexcept -> bool
+{
+    if (!detached || pending > 0)
+    {
+        return false;
+    }
+    delete this;
+    return true;
+}
+
+auto multishot_state::arm() noexcept -> bool
+{
+    auto sqe = local_engine().get_free_urs();
+    if (sqe == nullptr)
+    {
+        return false;
+    }
+    prep(sqe, this);
+    io_uring_sqe_set_data(sqe, static_cast<io_info*>(this));
+    local_engine().add_io_submit();
+    armed = true;
+    pending++;
+    return true;
+}
+
+auto multishot_stream::next_awaiter::await_suspend(std::coroutine_handle<> handle) noexcept -> bool
+{
+    if (!state->armed && !state->arm())
+    {
+        // sqe 耗尽时以 -EBUSY 结束本次等待，由调用方决定是否重试
+        state->cqes.emplace_back(-EBUSY, 0);
+        return false;
+    }
+    state->handle = handle;
+    return true;
+}
+
+multishot_stream::multishot_stream(
+    int fd, int io_flag, int sqe_flag, multishot_prep_type prep, multishot_drop_type drop) noexcept
+    : m_state(new multishot_state())
+{
+    m_state->type           = io_type::none;
+    m_state->cb             = &multishot_state::callback;
+    m_state->handle         = nullptr;
+    m_state->fd             = fd;
+    m_state->io_flag        = io_flag;
+    m_state->sqe_flag       = sqe_flag;
+    m_state->prep           = prep;
+    m_state->drop           = drop;
+    m_state->cancel_info.cb = &multishot_state::cancel_callback;
+    m_state->cancel_info.state = m_state;
+}
+
+auto multishot_stream::close() noexcept -> void
+{
+    if (m_state == nullptr)
+    {
+        return;
+    }
+    auto state      = std::exchange(m_state, nullptr);
+    state->detached = true;
+    state->handle   = nullptr;
+
+    if (state->drop != nullptr)
+    {
+        for (auto [res, flags] : state->cqes)
+        {
+            state->drop(state, res, flags);
+        }
+    }
+    state->cqes.clear();
+
+    if (state->armed)
+    {
+        // 取消 multishot 请求，state 在最后一个 cqe 和取消请求都完成后释放
+        state->cancel();
+    }
+    state->try_destroy();
+}
+
+}; // namespace coro::io::detail
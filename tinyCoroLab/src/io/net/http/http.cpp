@@ -0,0 +1,196 @@
+#include <charconv>
+
+#include "coro/io/net/http/http.hpp"
+#include "coro/utils.hpp"
+
+namespace coro::io::net::http
+{
+auto to_method(std::string_view token) noexcept -> method
+{
+    // 按长度分组，避免逐个比较所有方法
+    switch (token.size())
+    {
+        case 3:
+            return token == "GET" ? method::get : token == "PUT" ? method::put : method::unknown;
+        case 4:
+            return token == "POST" ? method::post : token == "HEAD" ? method::head : method::unknown;
+        case 5:
+            return token == "PATCH" ? method::patch : token == "TRACE" ? method::trace : method::unknown;
+        case 6:
+            return token == "DELETE" ? method::del : method::unknown;
+        case 7:
+            return token == "OPTIONS" ? method::options : token == "CONNECT" ? method::connect : method::unknown;
+        default:
+            return method::unknown;
+    }
+}
+
+auto method_token(method m) noexcept -> std::string_view
+{
+    switch (m)
+    {
+        case method::get:
+            return "GET";
+        case method::head:
+            return "HEAD";
+        case method::post:
+            return "POST";
+        case method::put:
+            return "PUT";
+        case method::del:
+            return "DELETE";
+        case method::connect:
+            return "CONNECT";
+        case method::options:
+            return "OPTIONS";
+        case method::trace:
+            return "TRACE";
+        case method::patch:
+            return "PATCH";
+        default:
+            return {};
+    }
+}
+
+auto reason_phrase(int status) noexcept -> std::string_view
+{
+    switch (status)
+    {
+        case 100:
+            return "Continue";
+        case 200:
+            return "OK";
+        case 201:
+            return "Created";
+        case 202:
+            return "Accepted";
+        case 204:
+            return "No Content";
+        case 206:
+            return "Partial Content";
+        case 301:
+            return "Moved Permanently";
+        case 302:
+            return "Found";
+        case 304:
+            return "Not Modified";
+        case 400:
+            return "Bad Request";
+        case 401:
+            return "Unauthorized";
+        case 403:
+            return "Forbidden";
+        case 404:
+            return "Not Found";
+        case 405:
+            return "Method Not Allowed";
+        case 408:
+            return "Request Timeout";
+        case 411:
+            return "Length Required";
+        case 413:
+            return "Payload Too Large";
+        case 414:
+            return "URI Too Long";
+        case 431:
+            return "Request Header Fields Too Large";
+        case 500:
+            return "Internal Server Error";
+        case 501:
+            return "Not Implemented";
+        case 503:
+            return "Service Unavailable";
+        case 505:
+            return "HTTP Version Not Supported";
+        default:
+            return {};
+    }
+}
+
+auto request::get_header(std::string_view name) const noexcept -> std::string_view
+{
+    for (auto& field : m_headers)
+    {
+        if (utils::equal(field.name, name))
+        {
+            return field.value;
+        }
+    }
+    return {};
+}
+
+auto request::reset() noexcept -> void
+{
+    m_method        = method::unknown;
+    m_method_token  = {};
+    m_target        = {};
+    m_path          = {};
+    m_query         = {};
+    m_version_minor = 1;
+    m_headers.clear();
+    m_body       = {};
+    m_keep_alive = true;
+}
+
+auto response::add_header(std::string_view name, std::string_view value) -> response&
+{
+    m_headers.append(name).append(": ").append(value).append("\r\n");
+    return *this;
+}
+
+auto response::set_body(std::string body) noexcept -> response&
+{
+    m_body  = std::move(body);
+    m_owned = true;
+    return *this;
+}
+
+auto response::set_body_view(std::string_view body) noexcept -> response&
+{
+    m_body_view = body;
+    m_owned     = false;
+    return *this;
+}
+
+auto response::reset(const request& req) noexcept -> void
+{
+    m_status        = 200;
+    m_version_minor = req.get_version_minor();
+    m_keep_alive    = req.keep_alive();
+    m_head_only     = req.get_method() == method::head;
+    m_owned         = false;
+    m_headers.clear();
+    m_body.clear();
+    m_body_view = {};
+}
+
+auto response::serialize_head(std::string& out) const -> void
+{
+    char num[24];
+
+    out.append(m_version_minor == 0 ? "HTTP/1.0 " : "HTTP/1.1 ");
+    auto status_end = std::to_chars(num, num + sizeof(num), m_status).ptr;
+    out.append(num, status_end).push_back(' ');
+    out.append(reason_phrase(m_status)).append("\r\n");
+
+    // HEAD 响应的 Content-Length 与 GET 相同，但不发送 body。
+    // 1xx 与 204 禁止发送 Content-Length，304 的 Content-Length 须与 200 响应一致，handler 无从得知，同样不发送
+    if (!bodiless_status())
+    {
+        auto len_end = std::to_chars(num, num + sizeof(num), get_body().size()).ptr;
+        out.append("Content-Length: ").append(num, len_end).append("\r\n");
+    }
+
+    // HTTP/1.1 默认长连接，HTTP/1.0 默认短连接，只在与默认行为不同时发送 Connection
+    if (!m_keep_alive)
+    {
+        out.append("Connection: close\r\n");
+    }
+    else if (m_version_minor == 0)
+    {
+        out.append("Connection: keep-alive\r\n");
+    }
+    out.append(m_headers).append("\r\n");
+}
+
+}; // namespace coro::io::net::http
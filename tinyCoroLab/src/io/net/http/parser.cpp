@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#include "config.h"
+#include "coro/detail/simd.hpp"
+#include "coro/io/net/http/parser.hpp"
+#include "coro/utils.hpp"
+
+namespace coro::io::net::http
+{
+static_assert(
+    config::kHttpRequestUriMaxLength < config::kHttpHeaderMaxLength,
+    "request target longer than kHttpRequestUriMaxLength must fit in head to be answered with 414");
+
+namespace
+{
+inline auto is_ows(char c) noexcept -> bool
+{
+    return c == ' ' || c == '\t';
+}
+
+inline auto trim_ows(std::string_view s) noexcept -> std::string_view
+{
+    while (!s.empty() && is_ows(s.front()))
+    {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && is_ows(s.back()))
+    {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+inline auto find_char(const char* first, const char* last, char ch) noexcept -> const char*
+{
+    auto pos = static_cast<const char*>(std::memchr(first, ch, last - first));
+    return pos == nullptr ? last : pos;
+}
+
+// 判断逗号分隔的列表中是否包含 token，如 "Connection: keep-alive, Upgrade"
+inline auto has_token(std::string_view list, std::string_view token) noexcept -> bool
+{
+    while (!list.empty())
+    {
+        auto pos  = list.find(',');
+        auto item = trim_ows(list.substr(0, pos));
+        if (utils::equal(item, token))
+        {
+            return true;
+        }
+        if (pos == std::string_view::npos)
+        {
+            break;
+        }
+        list.remove_prefix(pos + 1);
+    }
+    return false;
+}
+}; // namespace
+
+auto request_parser::parse(std::string_view data, request& req) noexcept -> parse_status
+{
+    if (m_head_len == 0)
+    {
+        // 请求行之前的空行需要忽略
+        if (m_scanned <= m_skip + 1)
+        {
+            while (m_skip + 1 < data.size() && data[m_skip] == '\r' && data[m_skip + 1] == '\n')
+            {
+                m_skip += 2;
+            }
+            m_scanned = m_skip;
+        }
+
+        // 上次扫描的末尾可能是 "\r\n\r" 的一部分，回退三个字节继续查找
+        auto from = std::max(m_skip, m_scanned >= 3 ? m_scanned - 3 : 0);
+        auto end  = coro::detail::simd::find_head_end(data.data() + from, data.data() + data.size());
+        if (end == nullptr)
+        {
+            m_scanned = data.size();
+            return data.size() > config::kHttpHeaderMaxLength ? fail(431) : parse_status::partial;
+        }
+
+        // 空行也计入头部长度，避免只发送空行使 buffer 无限增长
+        m_head_len = end - (data.data() + m_skip);
+        if (m_skip + m_head_len > config::kHttpHeaderMaxLength)
+        {
+            return fail(431);
+        }
+        if (auto status = parse_head(data.substr(m_skip, m_head_len - 2), req); status != parse_status::complete)
+        {
+            return status;
+        }
+    }
+    else
+    {
+        // 头部在之前的调用中已解析，但 buffer 可能已移动，重新解析使 req 指向新的位置
+        parse_head(data.substr(m_skip, m_head_len - 2), req);
+    }
+
+    if (data.size() < consumed())
+    {
+        return parse_status::partial;
+    }
+    req.m_body = data.substr(m_skip + m_head_len, m_body_len);
+    return parse_status::complete;
+}
+
+auto request_parser::parse_head(std::string_view head, request& req) noexcept -> parse_status
+{
+    req.reset();
+    m_body_len   = 0;
+    m_has_length = false;
+    m_connection = connection_type::none;
+
+    // 每一行都以 "\r\n" 结尾，各行只扫描一次
+    auto last  = head.data() + head.size();
+    auto first = parse_request_line(head.data(), last, req);
+    while (first != nullptr && first != last)
+    {
+        first = parse_header_line(first, last, req);
+    }
+    if (first == nullptr)
+    {
+        return parse_status::error;
+    }
+
+    // HTTP/1.1 默认长连接，HTTP/1.0 需要显式声明 keep-alive
+    if (m_connection == connection_type::close)
+    {
+        req.m_keep_alive = false;
+    }
+    else
+    {
+        req.m_keep_alive = req.m_version_minor == 1 || m_connection == connection_type::keep_alive;
+    }
+    return parse_status::complete;
+}
+
+auto request_parser::parse_request_line(const char* first, const char* last, request& req) noexcept -> const char*
+{
+    // '\r' 出现在空格之前说明请求行缺少字段
+    auto sp1 = coro::detail::simd::find_any(first, last, ' ', '\r');
+    if (sp1 == first || sp1 == last || *sp1 != ' ')
+    {
+        fail(400);
+        return nullptr;
+    }
+    auto sp2 = coro::detail::simd::find_any(sp1 + 1, last, ' ', '\r');
+    if (sp2 == sp1 + 1 || sp2 == last || *sp2 != ' ')
+    {
+        fail(400);
+        return nullptr;
+    }
+
+    req.m_method_token = std::string_view(first, sp1 - first);
+    req.m_method       = to_method(req.m_method_token);
+    req.m_target       = std::string_view(sp1 + 1, sp2 - sp1 - 1);
+    if (req.m_target.size() > config::kHttpRequestUriMaxLength)
+    {
+        fail(414);
+        return nullptr;
+    }
+
+    auto query = req.m_target.find('?');
+    req.m_path = req.m_target.substr(0, query);
+    if (query != std::string_view::npos)
+    {
+        req.m_query = req.m_target.substr(query + 1);
+    }
+
+    // 版本号固定为 8 个字节，其后紧跟 "\r\n"
+    auto version = sp2 + 1;
+    if (last - version < 10 || version[8] != '\r' || version[9] != '\n' ||
+        std::memcmp(version, "HTTP/", 5) != 0 || version[6] != '.')
+    {
+        fail(400);
+        return nullptr;
+    }
+    if (version[5] != '1' || (version[7] != '0' && version[7] != '1'))
+    {
+        fail(505);
+        return nullptr;
+    }
+    req.m_version_minor = version[7] - '0';
+    return version + 10;
+}
+
+auto request_parser::parse_header_line(const char* first, const char* last, request& req) noexcept -> const char*
+{
+    // 以空白开头的是已废弃的折叠行，名称与冒号之间也不允许有空白
+    auto colon = coro::detail::simd::find_any(first, last, ':', '\r');
+    if (colon == first || colon == last || *colon != ':' || is_ows(*first) || is_ows(colon[-1]))
+    {
+        fail(400);
+        return nullptr;
+    }
+    auto cr = find_char(colon + 1, last, '\r');
+    if (cr + 1 >= last || cr[1] != '\n')
+    {
+        fail(400);
+        return nullptr;
+    }
+
+    std::string_view name(first, colon - first);
+    auto             value = trim_ows(std::string_view(colon + 1, cr - colon - 1));
+    req.m_headers.push_back(header{name, value});
+
+    if (utils::equal(name, "content-length"))
+    {
+        uint64_t len = 0;
+        auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), len);
+        if (ec != std::errc{} || end != value.data() + value.size() || value.empty())
+        {
+            fail(400);
+            return nullptr;
+        }
+        if (m_has_length && len != m_body_len)
+        {
+            fail(400);
+            return nullptr;
+        }
+        if (len > config::kHttpPayloadMaxLength)
+        {
+            fail(413);
+            return nullptr;
+        }
+        m_has_length = true;
+        m_body_len   = len;
+    }
+    else if (utils::equal(name, "transfer-encoding"))
+    {
+        fail(501);
+        return nullptr;
+    }
+    else if (utils::equal(name, "connection"))
+    {
+        if (has_token(value, "close"))
+        {
+            m_connection = connection_type::close;
+        }
+        else if (m_connection != connection_type::close && has_token(value, "keep-alive"))
+        {
+            m_connection = connection_type::keep_alive;
+        }
+    }
+    return cr + 2;
+}
+
+}; // namespace coro::io::net::http
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cassert>
+
+#include "coro/io/net/http/router.hpp"
+
+namespace coro::io::net::http
+{
+auto router::add_route(method m, std::string_view path, route_handler handler) -> void
+{
+    assert(m != method::unknown && "can't route unknown method");
+    auto idx = static_cast<size_t>(m);
+    if (!path.empty() && path.back() == '*')
+    {
+        path.remove_suffix(1);
+        auto it = std::find_if(m_prefix.begin(), m_prefix.end(), [&](auto& item) { return item.first == path; });
+        if (it == m_prefix.end())
+        {
+            // 保持前缀按长度降序，匹配时第一个命中的即为最长前缀
+            it = std::find_if(
+                m_prefix.begin(), m_prefix.end(), [&](auto& item) { return item.first.size() < path.size(); });
+            it = m_prefix.emplace(it, std::string(path), method_handlers{});
+        }
+        it->second[idx] = std::move(handler);
+        return;
+    }
+
+    auto it = m_exact.find(path);
+    if (it == m_exact.end())
+    {
+        it = m_exact.emplace(std::string(path), method_handlers{}).first;
+    }
+    it->second[idx] = std::move(handler);
+}
+
+auto router::find_handler(const method_handlers& handlers, method m) const noexcept -> const route_handler*
+{
+    auto& handler = handlers[static_cast<size_t>(m)];
+    if (handler)
+    {
+        return &handler;
+    }
+    // HEAD 请求复用 GET 的处理函数，发送时去掉 body
+    if (m == method::head && handlers[static_cast<size_t>(method::get)])
+    {
+        return &handlers[static_cast<size_t>(method::get)];
+    }
+    return nullptr;
+}
+
+auto router::find_handlers(std::string_view path) const noexcept -> const method_handlers*
+{
+    if (auto it = m_exact.find(path); it != m_exact.end())
+    {
+        return &it->second;
+    }
+    for (auto& [prefix, prefix_handlers] : m_prefix)
+    {
+        if (path.starts_with(prefix))
+        {
+            return &prefix_handlers;
+        }
+    }
+    return nullptr;
+}
+
+auto router::match(const request& req, int& status) const noexcept -> const route_handler*
+{
+    if (req.get_method() == method::unknown)
+    {
+        status = 501;
+        return nullptr;
+    }
+
+    auto handlers = find_handlers(req.get_path());
+    if (handlers == nullptr)
+    {
+        status = 404;
+        return nullptr;
+    }
+    auto handler = find_handler(*handlers, req.get_method());
+    if (handler == nullptr)
+    {
+        status = 405;
+    }
+    return handler;
+}
+
+auto router::allow(std::string_view path) const -> std::string
+{
+    std::string out;
+    auto        handlers = find_handlers(path);
+    if (handlers == nullptr)
+    {
+        return out;
+    }
+    for (size_t i = 0; i < kMethodNum; i++)
+    {
+        auto m = static_cast<method>(i);
+        if (find_handler(*handlers, m) == nullptr)
+        {
+            continue;
+        }
+        if (!out.empty())
+        {
+            out.append(", ");
+        }
+        out.append(method_token(m));
+    }
+    return out;
+}
+
+}; // namespace coro::io::net::http
@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <vector>
+
+#include "coro/io/net/http/server.hpp"
+#include "coro/io/net/tcp/tcp.hpp"
+#include "coro/log.hpp"
+#include "coro/scheduler.hpp"
+#include "coro/timer.hpp"
+
+namespace coro::io::net::http
+{
+namespace
+{
+/**
+ * @brief state of one connection, lives in the frame of serve_connection
+ *
+ */
+class connection
+{
+public:
+    connection(int fd, const router& r) noexcept
+        : m_conn(fd),
+          m_router(r),
+          m_buf(config::kHttpReadBufferSize)
+    {
+    }
+
+    auto run() -> task<>;
+
+private:
+    // 取出下一个可复用的 response
+    auto next_response() -> response&
+    {
+        if (m_pending == m_responses.size())
+        {
+            m_responses.emplace_back();
+        }
+        return m_responses[m_pending++];
+    }
+
+    // 为下一次读取腾出空间
+    auto prepare_read() -> void;
+
+    // 序列化所有待发送响应的 head 并生成 iovec
+    auto prepare_write() -> void;
+
+private:
+    tcp::tcp_connector    m_conn;
+    const router&         m_router;
+    std::vector<char>     m_buf;
+    size_t                m_begin{0}; // first unparsed byte
+    size_t                m_end{0};   // end of received bytes
+    request_parser        m_parser;
+    request               m_req;
+    std::vector<response> m_responses;
+    size_t                m_pending{0}; // responses waiting to be sent
+    std::string           m_out;        // heads of pending responses
+    std::vector<size_t>   m_head_len;
+    std::vector<iovec>    m_iov;
+    size_t                m_served{0};
+};
+
+auto connection::prepare_read() -> void
+{
+    if (m_begin == m_end)
+    {
+        m_begin = m_end = 0;
+    }
+    else if (m_begin > 0)
+    {
+        // 未解析完的请求移到 buffer 头部，解析器只依赖相对位置
+        std::memmove(m_buf.data(), m_buf.data() + m_begin, m_end - m_begin);
+        m_end -= m_begin;
+        m_begin = 0;
+    }
+
+    if (m_end == m_buf.size())
+    {
+        // 解析器保证请求不超过头部与 body 的长度限制，buffer 不会无限增长
+        constexpr size_t max_size = config::kHttpHeaderMaxLength + config::kHttpPayloadMaxLength;
+        m_buf.resize(std::min(m_buf.size() * 2, max_size));
+    }
+}
+
+auto connection::prepare_write() -> void
+{
+    m_out.clear();
+    m_head_len.clear();
+    for (size_t i = 0; i < m_pending; i++)
+    {
+        auto old = m_out.size();
+        m_responses[i].serialize_head(m_out);
+        m_head_len.push_back(m_out.size() - old);
+    }
+
+    // m_out 不再变化后才能取地址
+    m_iov.clear();
+    auto offset = m_out.data();
+    for (size_t i = 0; i < m_pending; i++)
+    {
+        if (!m_iov.empty() && static_cast<char*>(m_iov.back().iov_base) + m_iov.back().iov_len == offset)
+        {
+            // 上一个响应没有 body，与相邻的 head 合并
+            m_iov.back().iov_len += m_head_len[i];
+        }
+        else
+        {
+            m_iov.push_back(iovec{offset, m_head_len[i]});
+        }
+        offset += m_head_len[i];
+
+        if (m_responses[i].has_body())
+        {
+            auto body = m_responses[i].get_body();
+            m_iov.push_back(iovec{const_cast<char*>(body.data()), body.size()});
+        }
+    }
+}
+
+auto connection::run() -> task<>
+{
+    bool closing = false;
+    while (true)
+    {
+        // 依次处理 buffer 中所有完整的请求，响应先缓存起来
+        while (!closing && m_pending < config::kHttpPipelineMaxCount)
+        {
+            auto status = m_parser.parse(std::string_view(m_buf.data() + m_begin, m_end - m_begin), m_req);
+            if (status == parse_status::partial)
+            {
+                break;
+            }
+
+            auto& resp = next_response();
+            if (status == parse_status::error)
+            {
+                m_req.reset();
+                resp.reset(m_req);
+                resp.set_status(m_parser.error_status()).set_keep_alive(false);
+                closing = true;
+                break;
+            }
+
+            resp.reset(m_req);
+            if (++m_served >= config::kHttpKeepAliveMaxCount)
+            {
+                resp.set_keep_alive(false);
+            }
+
+            int  code    = 200;
+            auto handler = m_router.match(m_req, code);
+            if (handler == nullptr)
+            {
+                resp.set_status(code);
+                if (code == 405)
+                {
+                    resp.add_header("Allow", m_router.allow(m_req.get_path()));
+                }
+            }
+            else
+            {
+                try
+                {
+                    if (handler->sync)
+                    {
+                        handler->sync(m_req, resp);
+                    }
+                    else
+                    {
+                        co_await handler->async(m_req, resp);
+                    }
+                }
+                catch (...)
+                {
+                    log::error("http handler of {} throws exception", m_req.get_path());
+                    resp.reset(m_req);
+                    resp.set_status(500);
+                }
+            }
+
+            closing = !resp.keep_alive();
+            // 请求数据要保留到响应发送完成，这里只移动解析位置
+            m_begin += m_parser.consumed();
+            m_parser.reset();
+        }
+
+        // 单批响应数达到上限时 buffer 中可能还有完整的请求，发送后不读取直接继续处理
+        bool batch_full = m_pending == config::kHttpPipelineMaxCount;
+        if (m_pending > 0)
+        {
+            // 所有缓存的响应通过一次 sendmsg 发送，短写由 awaiter 内部续写，对端关闭时不触发 SIGPIPE
+            prepare_write();
+            int ret = co_await m_conn.sendmsg(m_iov, MSG_NOSIGNAL);
+            if (ret < 0)
+            {
+                closing = true;
+            }
+            m_pending = 0;
+        }
+
+        if (closing)
+        {
+            break;
+        }
+        if (batch_full)
+        {
+            continue;
+        }
+
+        prepare_read();
+        int ret = co_await m_conn.read(m_buf.data() + m_end, m_buf.size() - m_end);
+        if (ret <= 0)
+        {
+            break;
+        }
+        m_end += ret;
+    }
+    co_await m_conn.close();
+}
+
+}; // namespace
+
+auto http_server::serve() -> task<>
+{
+    auto server = tcp::tcp_server(m_addr, m_port, config::kHttpListenBacklog);
+    auto stream = server.accept_multishot();
+    log::info("http server listen on port {}", m_port);
+    while (true)
+    {
+        int fd = co_await stream.next();
+        if (fd >= 0)
+        {
+            submit_to_scheduler(serve_connection(fd));
+            continue;
+        }
+        switch (-fd)
+        {
+            case ECONNABORTED:
+            case EINTR:
+            case EAGAIN:
+            case EPERM:
+            case EPROTO:
+                // 连接在被取出前已失效，继续取下一个
+                break;
+            case EMFILE:
+            case ENFILE:
+            case ENOBUFS:
+            case ENOMEM:
+            case EBUSY:
+                // fd、内存或 sqe 暂时耗尽，等待一段时间让现有连接释放资源后重试
+                log::warn("http server accept error: {}, retry later", fd);
+                co_await time::timer().set_by_duration(std::chrono::milliseconds(config::kHttpAcceptBackoffMSecond));
+                break;
+            default:
+                log::error("http server accept error: {}", fd);
+                co_return;
+        }
+    }
+}
+
+auto http_server::serve_connection(int fd) -> task<>
+{
+    if constexpr (config::kHttpTcpNodeLay)
+    {
+        int flag = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+    }
+    connection conn(fd, m_router);
+    co_await conn.run();
+}
+
+}; // namespace coro::io::net::http
@@ -6,13 +6,17 @@
 
 namespace coro::io::net::tcp
 {
-tcp_server::tcp_server(const char* addr, int port) noexcept
+tcp_server::tcp_server(const char* addr, int port, int backlog) noexcept
 {
     m_listenfd = socket(AF_INET, SOCK_STREAM, 0);
     assert(m_listenfd != -1);
 
     coro::utils::set_fd_noblock(m_listenfd);
 
+    // 服务端主动关闭的连接会处于 TIME_WAIT，允许重启后立即重新绑定端口
+    int reuse = 1;
+    setsockopt(m_listenfd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
     memset(&m_servaddr, 0, sizeof(m_servaddr));
     m_servaddr.sin_family = AF_INET;
     m_servaddr.sin_port   = htons(port);
@@ -35,7 +39,7 @@ tcp_server::tcp_server(const char* addr, int port) noexcept
         std::exit(1);
     }
 
-    if (listen(m_listenfd, ::coro::config::kBacklog) != 0)
+    if (listen(m_listenfd, backlog) != 0)
     {
         log::error("server listen error");
         std::exit(1);
@@ -50,6 +54,11 @@ tcp_accept_awaiter tcp_server::accept(int io_flags) noexcept
     return tcp_accept_awaiter(m_listenfd, io_flags, m_sqe_flag);
 }
 
+tcp_accept_stream tcp_server::accept_multishot(int io_flags) noexcept
+{
+    return tcp_accept_stream(m_listenfd, io_flags, m_sqe_flag);
+}
+
 tcp_client::tcp_client(const char* addr, int port) noexcept
 {
     m_clientfd = socket(AF_INET, SOCK_STREAM, 0);
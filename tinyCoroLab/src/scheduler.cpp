@@ -1,5 +1,6 @@
 #include "coro/scheduler.hpp"
 #include "coro/context.hpp"
+#include "coro/log.hpp"
 #include <atomic>
 #include <memory>
 
@@ -31,6 +32,60 @@ auto scheduler::init_impl(size_t ctx_cnt) noexcept -> void
 #endif
 }
 
+template<detail::dispatch_strategy dst>
+auto scheduler::steal_task_impl(size_t ctx_id) noexcept -> bool
+{
+    if constexpr (dst == detail::dispatch_strategy::work_stealing)
+    {
+        detail::dispatcher<dst>& dispatcher = m_dispatcher;
+
+        // 先标记为空闲再寻找 victim，保证其他 context 在此之后积压的任务能唤醒自己
+        dispatcher.mark_idle(ctx_id);
+        auto victim_id = dispatcher.select_victim(ctx_id);
+        if (victim_id == ctx_id)
+        {
+            return false;
+        }
+        dispatcher.mark_busy(ctx_id);
+
+        // 窃取前先把自己标记为活跃，避免任务离开 victim 队列的瞬间 stop token 归零，
+        // 但 stop token 已经归零说明 scheduler 正在停止，此时不再窃取
+        if (std::atomic_ref(m_ctx_stop_flag[ctx_id].val).fetch_or(1, memory_order_acq_rel) == 0)
+        {
+            auto token = m_stop_token.load(memory_order_acquire);
+            do
+            {
+                if (token == 0)
+                {
+                    std::atomic_ref(m_ctx_stop_flag[ctx_id].val).store(0, std::memory_order_release);
+                    return false;
+                }
+            } while (!m_stop_token.compare_exchange_weak(token, token + 1, memory_order_acq_rel));
+        }
+
+        if (dispatcher.steal(ctx_id, victim_id) == 0)
+        {
+            dispatcher.mark_idle(ctx_id);
+            return false;
+        }
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+template<detail::dispatch_strategy dst>
+auto scheduler::notify_idle_impl(size_t ctx_id) noexcept -> void
+{
+    if constexpr (dst == detail::dispatch_strategy::work_stealing)
+    {
+        detail::dispatcher<dst>& dispatcher = m_dispatcher;
+        dispatcher.notify_idle(ctx_id);
+    }
+}
+
 auto scheduler::start_impl() noexcept -> void
 {
     for (int i = 0; i < m_ctx_cnt; i++)
@@ -46,6 +101,11 @@ auto scheduler::start_impl() noexcept -> void
                     this->stop_impl();
                 }
             });
+        if constexpr (config::kDispatchStrategy == detail::dispatch_strategy::work_stealing)
+        {
+            m_ctxs[i]->set_steal_cb([&, i]() { return this->steal_task_impl(i); });
+            m_ctxs[i]->set_notify_cb([&, i]() { this->notify_idle_impl(i); });
+        }
         m_ctxs[i]->start();
     }
 }
@@ -58,6 +118,20 @@ auto scheduler::loop_impl() noexcept -> void
     {
         m_ctxs[i]->join();
     }
+
+#if defined(ENABLE_MEMORY_ALLOC) && defined(ENABLE_MEMORY_PROFILE)
+    // 保存协程帧大小分布，slab 分配器下次启动时可据此推导 size class
+    auto& profiler = coro::allocator::memory::frame_profiler::instance();
+    auto  path     = std::string(SOURCE_DIR) + config::kMemoryProfileFile;
+    if (!profiler.profile().save(path))
+    {
+        log::warn("save frame profile to {} failed", path);
+    }
+    for (auto& stat : profiler.stats())
+    {
+        log::info("context {} frame live: {}, peak: {}, total: {}", stat.ctx_id, stat.live, stat.peak, stat.total);
+    }
+#endif
 }
 
 auto scheduler::stop_impl() noexcept -> void
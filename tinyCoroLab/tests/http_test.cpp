@@ -0,0 +1,581 @@
+#include <arpa/inet.h>
+#include <chrono>
+#include <csignal>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#include "config.h"
+#include "coro/coro.hpp"
+#include "coro/io/net/http/parser.hpp"
+#include "coro/io/net/http/router.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro;
+using namespace coro::io::net::http;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+class ParserTest : public ::testing::Test
+{
+protected:
+    void SetUp() override { m_parser.reset(); }
+
+    auto parse(std::string_view data) -> parse_status { return m_parser.parse(data, m_req); }
+
+    request_parser m_parser;
+    request        m_req;
+};
+
+class ParserErrorTest : public ParserTest, public ::testing::WithParamInterface<std::pair<std::string, int>>
+{
+};
+
+class RouterTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_hit = "";
+        m_router.get("/", [this](const request&, response&) { m_hit = "root"; })
+            .get("/index", [this](const request&, response&) { m_hit = "get index"; })
+            .post("/index", [this](const request&, response&) { m_hit = "post index"; })
+            .get("/static/*", [this](const request&, response&) { m_hit = "static"; })
+            .get("/static/img/*", [this](const request&, response&) { m_hit = "img"; })
+            .route(method::head, "/head", [this](const request&, response&) { m_hit = "head"; });
+    }
+
+    // parse one request and match it, return the handler name or the error status
+    auto match(std::string_view data) -> std::string
+    {
+        request_parser parser;
+        EXPECT_EQ(parser.parse(data, m_req), parse_status::complete);
+        int  status  = 0;
+        auto handler = m_router.match(m_req, status);
+        if (handler == nullptr)
+        {
+            return std::to_string(status);
+        }
+        response resp;
+        handler->sync(m_req, resp);
+        return m_hit;
+    }
+
+    router      m_router;
+    request     m_req;
+    std::string m_hit;
+};
+
+class ResponseTest : public ::testing::Test
+{
+protected:
+    // serialize the head of response to request data
+    auto head_of(std::string_view data, int status, std::string_view body) -> std::string
+    {
+        request_parser parser;
+        EXPECT_EQ(parser.parse(data, m_req), parse_status::complete);
+        m_resp.reset(m_req);
+        m_resp.set_status(status).set_body(std::string(body));
+        std::string out;
+        m_resp.serialize_head(out);
+        return out;
+    }
+
+    request  m_req;
+    response m_resp;
+};
+
+task<> async_echo_handler(const request& req, response& resp)
+{
+    co_await time::timer{}.add_mseconds(10);
+    resp.set_body(std::string(req.get_query()));
+}
+
+/**
+ * @brief http_server::serve never returns, so the server runs in a child process for the whole
+ * test suite and is killed when the suite finishes, every test talks to it over a loopback socket
+ *
+ */
+class HttpServerTest : public ::testing::Test
+{
+protected:
+    struct reply
+    {
+        int         status{0};
+        std::string head;
+        std::string body;
+    };
+
+    static void SetUpTestSuite()
+    {
+        // io_uring of a killed server may still hold its listening socket for a while,
+        // so every suite takes a free port instead of a fixed one
+        s_port = free_port();
+        s_pid  = fork();
+        if (s_pid == 0)
+        {
+            run_server();
+            _exit(0);
+        }
+    }
+
+    static void TearDownTestSuite()
+    {
+        kill(s_pid, SIGKILL);
+        waitpid(s_pid, nullptr, 0);
+    }
+
+    void SetUp() override
+    {
+        ASSERT_GT(s_pid, 0);
+        m_fd = connect_server();
+        ASSERT_GE(m_fd, 0);
+    }
+
+    void TearDown() override
+    {
+        if (m_fd >= 0)
+        {
+            ::close(m_fd);
+        }
+    }
+
+    static auto free_port() -> int
+    {
+        int         fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        socklen_t   len      = sizeof(addr);
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        ::close(fd);
+        return ntohs(addr.sin_port);
+    }
+
+    static auto run_server() -> void
+    {
+        http_server server(s_port);
+        server.get_router()
+            .get("/echo", [](const request& req, response& resp) { resp.set_body(std::string(req.get_query())); })
+            .post("/echo", [](const request& req, response& resp) { resp.set_body_view(req.get_body()); })
+            .get("/async", async_echo_handler);
+
+        scheduler::init(2);
+        submit_to_scheduler(server.serve());
+        scheduler::loop();
+    }
+
+    // server may not listen yet, retry for a while
+    static auto connect_server() -> int
+    {
+        for (int i = 0; i < 500; i++)
+        {
+            int         fd = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in addr{};
+            addr.sin_family      = AF_INET;
+            addr.sin_port        = htons(s_port);
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0)
+            {
+                return fd;
+            }
+            ::close(fd);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return -1;
+    }
+
+    auto send_all(std::string_view data) -> void
+    {
+        while (!data.empty())
+        {
+            auto ret = ::send(m_fd, data.data(), data.size(), MSG_NOSIGNAL);
+            ASSERT_GT(ret, 0);
+            data.remove_prefix(ret);
+        }
+    }
+
+    // receive more bytes, return false if peer is closed or nothing arrives in time
+    auto recv_more() -> bool
+    {
+        pollfd pfd{.fd = m_fd, .events = POLLIN, .revents = 0};
+        if (poll(&pfd, 1, 5000) != 1)
+        {
+            return false;
+        }
+        char buf[4096];
+        auto ret = ::recv(m_fd, buf, sizeof(buf), 0);
+        if (ret <= 0)
+        {
+            return false;
+        }
+        m_in.append(buf, ret);
+        return true;
+    }
+
+    // read one response whose length is given by Content-Length
+    auto read_reply(reply& r) -> bool
+    {
+        while (true)
+        {
+            auto head_end = m_in.find("\r\n\r\n");
+            if (head_end != std::string::npos)
+            {
+                r.head      = m_in.substr(0, head_end + 4);
+                r.status    = std::stoi(r.head.substr(9, 3));
+                size_t len  = 0;
+                auto   hdr  = r.head.find("Content-Length: ");
+                if (hdr != std::string::npos)
+                {
+                    len = std::stoul(r.head.substr(hdr + 16));
+                }
+                if (m_in.size() >= r.head.size() + len)
+                {
+                    r.body = m_in.substr(r.head.size(), len);
+                    m_in.erase(0, r.head.size() + len);
+                    return true;
+                }
+            }
+            if (!recv_more())
+            {
+                return false;
+            }
+        }
+    }
+
+    // all responses are read and server closes the connection
+    auto peer_closed() -> bool { return m_in.empty() && !recv_more() && m_in.empty(); }
+
+    static auto get(std::string_view path, std::string_view query) -> std::string
+    {
+        return "GET " + std::string(path) + "?" + std::string(query) + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    }
+
+    static auto post(std::string_view body) -> std::string
+    {
+        return "POST /echo HTTP/1.1\r\nHost: localhost\r\nContent-Length: " + std::to_string(body.size()) +
+               "\r\n\r\n" + std::string(body);
+    }
+
+    inline static int   s_port{0};
+    inline static pid_t s_pid{-1};
+
+    int         m_fd{-1};
+    std::string m_in;
+};
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST_F(ParserTest, ParseSimpleRequest)
+{
+    std::string data = "GET /index?a=1 HTTP/1.1\r\nHost: localhost\r\nX-Test:  v \r\n\r\n";
+    ASSERT_EQ(parse(data), parse_status::complete);
+    ASSERT_EQ(m_parser.consumed(), data.size());
+    ASSERT_EQ(m_req.get_method(), method::get);
+    ASSERT_EQ(m_req.get_target(), "/index?a=1");
+    ASSERT_EQ(m_req.get_path(), "/index");
+    ASSERT_EQ(m_req.get_query(), "a=1");
+    ASSERT_EQ(m_req.get_version_minor(), 1);
+    ASSERT_EQ(m_req.get_header("host"), "localhost");
+    ASSERT_EQ(m_req.get_header("x-test"), "v");
+    ASSERT_TRUE(m_req.get_body().empty());
+    ASSERT_TRUE(m_req.keep_alive());
+}
+
+TEST_F(ParserTest, ParsePipelinedRequests)
+{
+    std::string data = "GET /a HTTP/1.1\r\n\r\n"
+                       "POST /b HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello"
+                       "\r\nGET /c HTTP/1.1\r\nConnection: close\r\n\r\n";
+
+    std::string_view rest = data;
+    ASSERT_EQ(parse(rest), parse_status::complete);
+    ASSERT_EQ(m_req.get_path(), "/a");
+    rest.remove_prefix(m_parser.consumed());
+    m_parser.reset();
+
+    ASSERT_EQ(parse(rest), parse_status::complete);
+    ASSERT_EQ(m_req.get_method(), method::post);
+    ASSERT_EQ(m_req.get_path(), "/b");
+    ASSERT_EQ(m_req.get_body(), "hello");
+    rest.remove_prefix(m_parser.consumed());
+    m_parser.reset();
+
+    // empty line before request line is skipped
+    ASSERT_EQ(parse(rest), parse_status::complete);
+    ASSERT_EQ(m_req.get_path(), "/c");
+    ASSERT_FALSE(m_req.keep_alive());
+    ASSERT_EQ(m_parser.consumed(), rest.size());
+}
+
+TEST_F(ParserTest, ParseHeadSplitAcrossReads)
+{
+    std::string data = "POST /upload HTTP/1.1\r\nHost: localhost\r\nContent-Length: 4\r\n\r\nbody";
+
+    // feed one byte more every time, the buffer is copied so the data moves between calls
+    for (size_t len = 1; len < data.size(); len++)
+    {
+        std::string part = data.substr(0, len);
+        ASSERT_EQ(parse(part), parse_status::partial) << "len " << len;
+    }
+    std::string whole = data;
+    ASSERT_EQ(parse(whole), parse_status::complete);
+    ASSERT_EQ(m_parser.consumed(), data.size());
+    ASSERT_EQ(m_req.get_path(), "/upload");
+    ASSERT_EQ(m_req.get_header("host"), "localhost");
+    ASSERT_EQ(m_req.get_body(), "body");
+    ASSERT_EQ(m_req.get_body().data(), whole.data() + whole.size() - 4);
+}
+
+TEST_F(ParserTest, ParseHttp10KeepAlive)
+{
+    ASSERT_EQ(parse("GET / HTTP/1.0\r\n\r\n"), parse_status::complete);
+    ASSERT_EQ(m_req.get_version_minor(), 0);
+    ASSERT_FALSE(m_req.keep_alive());
+
+    m_parser.reset();
+    ASSERT_EQ(parse("GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n"), parse_status::complete);
+    ASSERT_TRUE(m_req.keep_alive());
+
+    m_parser.reset();
+    ASSERT_EQ(parse("GET / HTTP/1.0\r\nConnection: keep-alive, close\r\n\r\n"), parse_status::complete);
+    ASSERT_FALSE(m_req.keep_alive());
+
+    m_parser.reset();
+    ASSERT_EQ(parse("GET / HTTP/1.1\r\nConnection: close\r\n\r\n"), parse_status::complete);
+    ASSERT_FALSE(m_req.keep_alive());
+}
+
+TEST_F(ParserTest, ParseHeadTooLarge)
+{
+    std::string data = "GET / HTTP/1.1\r\nX-Long: " + std::string(config::kHttpHeaderMaxLength, 'a');
+    ASSERT_EQ(parse(data), parse_status::error);
+    ASSERT_EQ(m_parser.error_status(), 431);
+}
+
+TEST_P(ParserErrorTest, ParseError)
+{
+    auto& [data, status] = GetParam();
+    ASSERT_EQ(parse(data), parse_status::error);
+    ASSERT_EQ(m_parser.error_status(), status);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ParserErrorTests,
+    ParserErrorTest,
+    ::testing::Values(
+        std::make_pair(std::string("GET\r\n\r\n"), 400),
+        std::make_pair(std::string("GET / HTTP/1.1 \r\n\r\n"), 400),
+        std::make_pair(std::string("GET / HTTP/1.1\r\n: v\r\n\r\n"), 400),
+        std::make_pair(std::string("GET / HTTP/1.1\r\nHost : v\r\n\r\n"), 400),
+        std::make_pair(std::string("GET / HTTP/1.1\r\nContent-Length: x\r\n\r\n"), 400),
+        std::make_pair(std::string("GET / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n"), 400),
+        std::make_pair(
+            "POST / HTTP/1.1\r\nContent-Length: " + std::to_string(config::kHttpPayloadMaxLength + 1) + "\r\n\r\n",
+            413),
+        std::make_pair("GET /" + std::string(config::kHttpRequestUriMaxLength, 'a') + " HTTP/1.1\r\n\r\n", 414),
+        std::make_pair(std::string("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"), 501),
+        std::make_pair(std::string("GET / HTTP/2.0\r\n\r\n"), 505),
+        std::make_pair(std::string("GET / HTTP/1.2\r\n\r\n"), 505)));
+
+TEST_F(RouterTest, RouteExactPath)
+{
+    ASSERT_EQ(match("GET / HTTP/1.1\r\n\r\n"), "root");
+    ASSERT_EQ(match("GET /index HTTP/1.1\r\n\r\n"), "get index");
+    ASSERT_EQ(match("POST /index HTTP/1.1\r\n\r\n"), "post index");
+    ASSERT_EQ(match("GET /index?x=1 HTTP/1.1\r\n\r\n"), "get index");
+}
+
+TEST_F(RouterTest, RouteLongestPrefix)
+{
+    ASSERT_EQ(match("GET /static/ HTTP/1.1\r\n\r\n"), "static");
+    ASSERT_EQ(match("GET /static/a.css HTTP/1.1\r\n\r\n"), "static");
+    ASSERT_EQ(match("GET /static/img/a.png HTTP/1.1\r\n\r\n"), "img");
+    ASSERT_EQ(match("GET /static HTTP/1.1\r\n\r\n"), "404");
+}
+
+TEST_F(RouterTest, RouteHeadFallbackToGet)
+{
+    ASSERT_EQ(match("HEAD /index HTTP/1.1\r\n\r\n"), "get index");
+    ASSERT_EQ(match("HEAD /static/img/a.png HTTP/1.1\r\n\r\n"), "img");
+    ASSERT_EQ(match("HEAD /head HTTP/1.1\r\n\r\n"), "head");
+}
+
+TEST_F(RouterTest, RouteError)
+{
+    ASSERT_EQ(match("GET /none HTTP/1.1\r\n\r\n"), "404");
+    ASSERT_EQ(match("DELETE /index HTTP/1.1\r\n\r\n"), "405");
+    ASSERT_EQ(match("GET /head HTTP/1.1\r\n\r\n"), "405");
+    ASSERT_EQ(match("FOO /index HTTP/1.1\r\n\r\n"), "501");
+}
+
+TEST_F(RouterTest, RouteAllow)
+{
+    ASSERT_EQ(m_router.allow("/index"), "GET, HEAD, POST");
+    ASSERT_EQ(m_router.allow("/static/a.css"), "GET, HEAD");
+    ASSERT_EQ(m_router.allow("/head"), "HEAD");
+    ASSERT_EQ(m_router.allow("/none"), "");
+}
+
+TEST_F(ResponseTest, ResponseContentLength)
+{
+    auto head = head_of("GET / HTTP/1.1\r\n\r\n", 200, "hello");
+    ASSERT_NE(head.find("Content-Length: 5\r\n"), std::string::npos);
+    ASSERT_TRUE(m_resp.has_body());
+
+    // HEAD response has the same Content-Length as GET but no body
+    head = head_of("HEAD / HTTP/1.1\r\n\r\n", 200, "hello");
+    ASSERT_NE(head.find("Content-Length: 5\r\n"), std::string::npos);
+    ASSERT_FALSE(m_resp.has_body());
+
+    head = head_of("GET / HTTP/1.1\r\n\r\n", 404, "");
+    ASSERT_NE(head.find("Content-Length: 0\r\n"), std::string::npos);
+}
+
+TEST_F(ResponseTest, ResponseNoContentLength)
+{
+    for (int status : {100, 204, 304})
+    {
+        auto head = head_of("GET / HTTP/1.1\r\n\r\n", status, "hello");
+        ASSERT_EQ(head.find("Content-Length"), std::string::npos) << status;
+        ASSERT_FALSE(m_resp.has_body()) << status;
+        ASSERT_TRUE(head.ends_with("\r\n\r\n")) << status;
+    }
+}
+
+TEST_F(HttpServerTest, ServePipelinedRequests)
+{
+    // more than two batches, the requests don't fit in the initial read buffer either
+    const int   num = config::kHttpPipelineMaxCount * 2 + 3;
+    std::string data;
+    for (int i = 0; i < num; i++)
+    {
+        data += get(i % 10 == 0 ? "/async" : "/echo", std::to_string(i));
+    }
+    ASSERT_GT(data.size(), config::kHttpReadBufferSize);
+    send_all(data);
+
+    // responses keep request order, async handler included
+    for (int i = 0; i < num; i++)
+    {
+        reply r;
+        ASSERT_TRUE(read_reply(r));
+        ASSERT_EQ(r.status, 200);
+        ASSERT_EQ(r.body, std::to_string(i));
+    }
+
+    // connection is still alive
+    send_all(get("/echo", "next"));
+    reply r;
+    ASSERT_TRUE(read_reply(r));
+    ASSERT_EQ(r.body, "next");
+}
+
+TEST_F(HttpServerTest, ServeRequestSplitAcrossReads)
+{
+    auto data = post("0123456789");
+    for (size_t pos : {5UL, 20UL, data.size() - 4})
+    {
+        send_all(std::string_view(data).substr(0, pos));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        send_all(std::string_view(data).substr(pos));
+
+        reply r;
+        ASSERT_TRUE(read_reply(r));
+        ASSERT_EQ(r.status, 200);
+        ASSERT_EQ(r.body, "0123456789");
+    }
+}
+
+TEST_F(HttpServerTest, ServeBodyLargerThanReadBuffer)
+{
+    std::string body(config::kHttpReadBufferSize * 3 + 17, 0);
+    for (size_t i = 0; i < body.size(); i++)
+    {
+        body[i] = 'a' + i % 26;
+    }
+    // the following request is left in the buffer after the large one and moved to the front
+    send_all(get("/echo", "head") + post(body) + get("/echo", "tail"));
+
+    reply r;
+    ASSERT_TRUE(read_reply(r));
+    ASSERT_EQ(r.body, "head");
+    ASSERT_TRUE(read_reply(r));
+    ASSERT_EQ(r.status, 200);
+    ASSERT_EQ(r.body, body);
+    ASSERT_TRUE(read_reply(r));
+    ASSERT_EQ(r.body, "tail");
+}
+
+TEST_F(HttpServerTest, ServeConnectionClose)
+{
+    send_all("GET /echo?bye HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+
+    reply r;
+    ASSERT_TRUE(read_reply(r));
+    ASSERT_EQ(r.status, 200);
+    ASSERT_EQ(r.body, "bye");
+    ASSERT_NE(r.head.find("Connection: close\r\n"), std::string::npos);
+    ASSERT_TRUE(peer_closed());
+}
+
+TEST_F(HttpServerTest, ServeErrorClose)
+{
+    send_all(get("/echo", "ok") + "GET / HTTP/1.1\r\nContent-Length: x\r\n\r\n");
+
+    // requests before the bad one are answered, then the connection is closed
+    reply r;
+    ASSERT_TRUE(read_reply(r));
+    ASSERT_EQ(r.body, "ok");
+    ASSERT_TRUE(read_reply(r));
+    ASSERT_EQ(r.status, 400);
+    ASSERT_NE(r.head.find("Connection: close\r\n"), std::string::npos);
+    ASSERT_TRUE(peer_closed());
+}
+
+TEST_F(HttpServerTest, ServeMethodNotAllowed)
+{
+    send_all("PUT /echo HTTP/1.1\r\nHost: localhost\r\nContent-Length: 0\r\n\r\n");
+
+    reply r;
+    ASSERT_TRUE(read_reply(r));
+    ASSERT_EQ(r.status, 405);
+    ASSERT_NE(r.head.find("Allow: GET, HEAD, POST\r\n"), std::string::npos);
+}
+
+TEST_F(HttpServerTest, ServeKeepAliveMaxCount)
+{
+    // exactly the max count is sent, unread request would make the closing server reset the connection
+    std::string data;
+    for (size_t i = 0; i < config::kHttpKeepAliveMaxCount; i++)
+    {
+        data += get("/echo", std::to_string(i));
+    }
+    send_all(data);
+
+    for (size_t i = 0; i < config::kHttpKeepAliveMaxCount; i++)
+    {
+        reply r;
+        ASSERT_TRUE(read_reply(r));
+        ASSERT_EQ(r.body, std::to_string(i));
+        bool last = i + 1 == config::kHttpKeepAliveMaxCount;
+        ASSERT_EQ(r.head.find("Connection: close\r\n") != std::string::npos, last);
+    }
+    ASSERT_TRUE(peer_closed());
+}
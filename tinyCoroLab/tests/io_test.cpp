@@ -0,0 +1,450 @@
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "coro/coro.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro;
+using namespace coro::io::net::tcp;
+using coro::io::pooled_buffer;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+class SocketPairTest : public ::testing::Test
+{
+protected:
+    void SetUp() override { ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, m_fds), 0); }
+
+    void TearDown() override
+    {
+        ::close(m_fds[0]);
+        ::close(m_fds[1]);
+    }
+
+    // write len bytes to peer by blocking send, stop if peer is shut down
+    static auto write_all(int fd, size_t len) -> void
+    {
+        std::vector<char> buf(config::kBufRingBufSize, 'a');
+        while (len > 0)
+        {
+            auto ret = ::send(fd, buf.data(), std::min(len, buf.size()), MSG_NOSIGNAL);
+            if (ret <= 0)
+            {
+                return;
+            }
+            len -= ret;
+        }
+    }
+
+    int m_fds[2];
+};
+
+class WritevTest : public SocketPairTest
+{
+protected:
+    void SetUp() override
+    {
+        SocketPairTest::SetUp();
+        m_ret = 0;
+    }
+
+    int m_ret;
+};
+
+class AcceptStreamTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_listening = false;
+        m_connected = false;
+    }
+
+    void TearDown() override
+    {
+        for (auto fd : m_clients)
+        {
+            ::close(fd);
+        }
+    }
+
+    // connect to local port by blocking socket
+    static auto connect_local(int port) -> int
+    {
+        int         fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family      = AF_INET;
+        addr.sin_port        = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    std::atomic<bool> m_listening;
+    std::atomic<bool> m_connected;
+    std::vector<int>  m_accepted;
+    std::vector<int>  m_clients;
+};
+
+class RecvStreamTest : public SocketPairTest
+{
+protected:
+    void SetUp() override
+    {
+        SocketPairTest::SetUp();
+        m_received  = 0;
+        m_exhausted = 0;
+        m_error     = 0;
+    }
+
+    size_t m_received;
+    int    m_exhausted;
+    int    m_error;
+};
+
+// byte at offset of the stream written by RecvPooledTest::write_pattern
+inline auto pattern(size_t offset) -> char
+{
+    return static_cast<char>(offset % 251);
+}
+
+class RecvPooledTest : public SocketPairTest
+{
+protected:
+    void SetUp() override
+    {
+        SocketPairTest::SetUp();
+        m_received = 0;
+        m_nobufs   = 0;
+        m_error    = 0;
+    }
+
+    static auto write_pattern(int fd, size_t len) -> void
+    {
+        std::vector<char> buf(config::kBufRingBufSize);
+        size_t            offset = 0;
+        while (offset < len)
+        {
+            auto n = std::min(len - offset, buf.size());
+            for (size_t i = 0; i < n; i++)
+            {
+                buf[i] = pattern(offset + i);
+            }
+            auto ret = ::send(fd, buf.data(), n, MSG_NOSIGNAL);
+            if (ret <= 0)
+            {
+                return;
+            }
+            offset += ret;
+        }
+    }
+
+    size_t m_received;
+    int    m_nobufs;
+    int    m_error;
+};
+
+// borrow the whole ring, then give the buffers back from a thread without engine
+task<> recv_pooled_release_remote(int fd, size_t total, size_t& received, int& nobufs, int& error)
+{
+    tcp_connector              conn(fd);
+    std::vector<pooled_buffer> held;
+    while (received < total)
+    {
+        auto buf = co_await conn.recv_pooled();
+        if (buf.result() == -ENOBUFS)
+        {
+            // all buffers are borrowed, the buffers are returned to kernel by the next recv_pooled
+            EXPECT_EQ(held.size(), config::kBufRingEntries);
+            EXPECT_FALSE(buf.valid());
+            ++nobufs;
+            std::thread releaser([&held]() { held.clear(); });
+            releaser.join();
+            continue;
+        }
+        if (buf.result() <= 0 || !buf.valid())
+        {
+            error = buf.result();
+            break;
+        }
+        for (size_t i = 0; i < buf.size(); i++)
+        {
+            if (buf.data()[i] != pattern(received + i))
+            {
+                error = -EINVAL;
+                co_return;
+            }
+        }
+        received += buf.size();
+        held.push_back(std::move(buf));
+    }
+}
+
+// hold every buffer until the whole ring is borrowed, so kernel runs out of buffers
+task<> recv_hold_all(int fd, size_t total, size_t& received, int& exhausted, int& error)
+{
+    tcp_connector              conn(fd);
+    auto                       stream = conn.recv_multishot();
+    std::vector<pooled_buffer> held;
+    while (received < total)
+    {
+        auto buf = co_await stream.next();
+        if (buf.result() <= 0)
+        {
+            error = buf.result();
+            break;
+        }
+        received += buf.size();
+        held.push_back(std::move(buf));
+        if (held.size() == config::kBufRingEntries)
+        {
+            held.clear();
+            ++exhausted;
+        }
+    }
+}
+
+// iovecs are much larger than socket buffer, so writev is short written many times
+task<> writev_all(int fd, std::vector<std::vector<char>>& bufs, int& ret)
+{
+    tcp_connector      conn(fd);
+    std::vector<iovec> iov;
+    for (auto& buf : bufs)
+    {
+        iov.push_back(iovec{.iov_base = buf.data(), .iov_len = buf.size()});
+    }
+    ret = co_await conn.writev(iov);
+}
+
+// accept accept_num connections and close them, then wait for the rest to be queued in stream
+task<> accept_then_close(
+    int port, int accept_num, std::atomic<bool>& listening, std::atomic<bool>& connected, std::vector<int>& fds)
+{
+    tcp_server server(nullptr, port, 128);
+    {
+        auto stream = server.accept_multishot();
+        listening.store(true, std::memory_order_release);
+        for (int i = 0; i < accept_num; i++)
+        {
+            int fd = co_await stream.next();
+            fds.push_back(fd);
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+        while (!connected.load(std::memory_order_acquire))
+        {
+            co_await time::timer().set_by_duration(std::chrono::milliseconds(10));
+        }
+        co_await time::timer().set_by_duration(std::chrono::milliseconds(100));
+    }
+}
+
+void nop_cb([[CORO_MAYBE_UNUSED]] io::detail::io_info* info, [[CORO_MAYBE_UNUSED]] int res) {}
+
+// close stream when no sqe is free, so the cancel of multishot accept is deferred
+task<> accept_then_close_without_sqe(int port, std::atomic<bool>& listening, std::vector<int>& fds)
+{
+    tcp_server server(nullptr, port, 128);
+    {
+        auto stream = server.accept_multishot();
+        listening.store(true, std::memory_order_release);
+        int fd = co_await stream.next();
+        fds.push_back(fd);
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+
+        static io::detail::io_info info;
+        info.cb = nop_cb;
+        while (auto sqe = detail::local_engine().get_free_urs())
+        {
+            io_uring_prep_nop(sqe);
+            io_uring_sqe_set_data(sqe, &info);
+            detail::local_engine().add_io_submit();
+        }
+    }
+}
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST_F(AcceptStreamTest, AcceptStreamNextAndClose)
+{
+    const int port       = 8017;
+    const int accept_num = 16;
+    const int queued_num = 8;
+
+    scheduler::init(1);
+
+    submit_to_scheduler(accept_then_close(port, accept_num, m_listening, m_connected, m_accepted));
+
+    std::thread client(
+        [&]()
+        {
+            while (!m_listening.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < accept_num + queued_num; i++)
+            {
+                m_clients.push_back(connect_local(port));
+            }
+            m_connected.store(true, std::memory_order_release);
+        });
+
+    // loop returns only if multishot accept is cancelled when stream is closed
+    scheduler::loop();
+    client.join();
+
+    ASSERT_EQ(m_accepted.size(), static_cast<size_t>(accept_num));
+    for (auto fd : m_accepted)
+    {
+        ASSERT_GE(fd, 0);
+    }
+
+    // connections accepted but not fetched are closed by stream
+    ASSERT_EQ(m_clients.size(), static_cast<size_t>(accept_num + queued_num));
+    for (auto fd : m_clients)
+    {
+        ASSERT_GE(fd, 0);
+        pollfd pfd{.fd = fd, .events = POLLIN, .revents = 0};
+        ASSERT_EQ(poll(&pfd, 1, 1000), 1);
+        char c;
+        ASSERT_EQ(::recv(fd, &c, 1, 0), 0);
+    }
+}
+
+TEST_F(AcceptStreamTest, AcceptStreamCloseWithoutSqe)
+{
+    const int port = 8018;
+
+    scheduler::init(1);
+
+    submit_to_scheduler(accept_then_close_without_sqe(port, m_listening, m_accepted));
+
+    std::thread client(
+        [&]()
+        {
+            while (!m_listening.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+            m_clients.push_back(connect_local(port));
+        });
+
+    // loop returns only if the deferred cancel is submitted
+    scheduler::loop();
+    client.join();
+
+    ASSERT_EQ(m_accepted.size(), 1U);
+    ASSERT_GE(m_accepted[0], 0);
+}
+
+TEST_F(RecvStreamTest, RecvStreamBufRingExhausted)
+{
+    const size_t total = 3 * size_t(config::kBufRingEntries) * config::kBufRingBufSize;
+
+    scheduler::init(1);
+
+    submit_to_scheduler(recv_hold_all(m_fds[0], total, m_received, m_exhausted, m_error));
+
+    std::thread writer([&]() { write_all(m_fds[1], total); });
+
+    scheduler::loop();
+    // unblock writer if receiver quits early
+    shutdown(m_fds[0], SHUT_RDWR);
+    writer.join();
+
+    ASSERT_EQ(m_error, 0);
+    ASSERT_EQ(m_received, total);
+    ASSERT_GE(m_exhausted, 1);
+}
+
+TEST_F(WritevTest, WritevShortWrite)
+{
+    const int    iov_num  = 64;
+    const size_t iov_size = 64 * 1024;
+
+    std::vector<std::vector<char>> bufs;
+    for (int i = 0; i < iov_num; i++)
+    {
+        bufs.emplace_back(iov_size, char('a' + i % 26));
+    }
+
+    std::vector<char> received;
+    std::thread       reader(
+        [&]()
+        {
+            char buf[4096];
+            while (received.size() < iov_num * iov_size)
+            {
+                auto ret = ::read(m_fds[1], buf, sizeof(buf));
+                if (ret <= 0)
+                {
+                    return;
+                }
+                received.insert(received.end(), buf, buf + ret);
+            }
+        });
+
+    scheduler::init(1);
+
+    submit_to_scheduler(writev_all(m_fds[0], bufs, m_ret));
+
+    scheduler::loop();
+    shutdown(m_fds[0], SHUT_WR);
+    reader.join();
+
+    ASSERT_EQ(static_cast<size_t>(m_ret), iov_num * iov_size);
+    ASSERT_EQ(received.size(), iov_num * iov_size);
+    for (int i = 0; i < iov_num; i++)
+    {
+        ASSERT_EQ(received[i * iov_size], 'a' + i % 26);
+        ASSERT_EQ(received[(i + 1) * iov_size - 1], 'a' + i % 26);
+    }
+}
+
+TEST_F(RecvPooledTest, RecvPooledReleaseRemote)
+{
+    const size_t total = 3 * size_t(config::kBufRingEntries) * config::kBufRingBufSize;
+
+    scheduler::init(1);
+
+    submit_to_scheduler(recv_pooled_release_remote(m_fds[0], total, m_received, m_nobufs, m_error));
+
+    std::thread writer([&]() { write_pattern(m_fds[1], total); });
+
+    scheduler::loop();
+    // unblock writer if receiver quits early
+    shutdown(m_fds[0], SHUT_RDWR);
+    writer.join();
+
+    ASSERT_EQ(m_error, 0);
+    ASSERT_EQ(m_received, total);
+    ASSERT_GE(m_nobufs, 1);
+}
@@ -83,6 +83,21 @@ void io_cb_resume(io_info* info, int res)
     detail::local_engine().submit_task(info->handle); // 提交 协程句柄
 }
 
+// prepare nop for io, defer it if there is no free sqe
+void io_cb_retry(io_info* info, [[CORO_MAYBE_UNUSED]] int res)
+{
+    auto sqe = detail::local_engine().get_free_urs();
+    if (sqe == nullptr)
+    {
+        detail::local_engine().defer_io(info, io_cb_retry);
+        return;
+    }
+    info->cb = io_cb;
+    io_uring_prep_nop(sqe);
+    io_uring_sqe_set_data(sqe, info);
+    detail::local_engine().add_io_submit();
+}
+
 struct test_noop_awaiter
 {
     test_noop_awaiter(detail::engine& engine, io_info& info, int* data) noexcept : m_engine(engine), m_info(info)
@@ -236,6 +251,35 @@ TEST_F(EngineTest, ExecMultiDetachTaskByEngine)
     }
 }
 
+// test submit more tasks than local queue and task queue can hold by the thread
+// owns engine, overflow tasks shouldn't be executed on the submitter's stack
+TEST_F(EngineTest, ExecOverflowTaskByEngine)
+{
+    const int task_num = config::kLocalQueCap + config::kQueCap + 100;
+    for (int i = 0; i < task_num; i++)
+    {
+        auto task   = func(m_vec, i);
+        auto handle = task.handle();
+        task.detach();
+        m_engine.submit_task(handle);
+    }
+
+    ASSERT_EQ(m_vec.size(), 0);
+    ASSERT_EQ(m_engine.num_task_schedule(), task_num);
+    while (m_engine.ready())
+    {
+        m_engine.exec_one_task();
+    }
+    ASSERT_EQ(m_engine.num_task_schedule(), 0);
+    ASSERT_EQ(m_vec.size(), task_num);
+
+    std::sort(m_vec.begin(), m_vec.end());
+    for (int i = 0; i < task_num; i++)
+    {
+        ASSERT_EQ(m_vec[i], i);
+    }
+}
+
 // test submit task but exec by engine, the engine
 // shouldn't destroy task handler, otherwise cause pointer double free.
 TEST_F(EngineTest, ExecOneNoDetachTaskByEngine)
@@ -253,6 +297,115 @@ TEST_F(EngineTest, ExecOneNoDetachTaskByEngine)
     ASSERT_EQ(m_vec[0], 1);
 }
 
+// test steal detach tasks from another engine, stolen tasks
+// should be moved to thief engine and exec by thief engine
+TEST_F(EngineTest, StealDetachTaskFromEngine)
+{
+    const int task_num  = 100;
+    const int steal_num = 30;
+
+    detail::engine thief;
+    thief.init();
+
+    for (int i = 0; i < task_num; i++)
+    {
+        auto task = func(m_vec, i);
+        m_engine.submit_task(task.handle());
+        task.detach();
+    }
+
+    ASSERT_EQ(thief.steal_from(m_engine, steal_num), steal_num);
+    ASSERT_EQ(thief.num_task_schedule(), steal_num);
+    ASSERT_EQ(m_engine.num_task_schedule(), task_num - steal_num);
+
+    while (thief.ready())
+    {
+        thief.exec_one_task();
+    }
+    ASSERT_EQ(m_vec.size(), steal_num);
+    while (m_engine.ready())
+    {
+        m_engine.exec_one_task();
+    }
+    ASSERT_EQ(thief.steal_from(m_engine, steal_num), 0);
+
+    ASSERT_EQ(m_vec.size(), task_num);
+    std::sort(m_vec.begin(), m_vec.end());
+    for (int i = 0; i < task_num; i++)
+    {
+        ASSERT_EQ(m_vec[i], i);
+    }
+    thief.deinit();
+}
+
+// test tasks submitted by the thread owns engine, they should be stored in
+// local queue and lifo slot, the task in lifo slot can't be stolen
+TEST_F(EngineTest, StealLocalTaskFromEngine)
+{
+    const int task_num = 100;
+
+    for (int i = 0; i < task_num; i++)
+    {
+        auto task = func(m_vec, i);
+        m_engine.submit_task(task.handle());
+        task.detach();
+    }
+    ASSERT_EQ(m_engine.num_task_schedule(), task_num);
+
+    detail::engine thief;
+    thief.init();
+
+    ASSERT_EQ(thief.steal_from(m_engine, task_num), task_num - 1);
+    ASSERT_EQ(thief.num_task_schedule(), task_num - 1);
+    ASSERT_EQ(m_engine.num_task_schedule(), 1);
+
+    m_engine.exec_one_task();
+    ASSERT_FALSE(m_engine.ready());
+    ASSERT_EQ(m_vec.size(), 1);
+    ASSERT_EQ(m_vec[0], task_num - 1);
+
+    while (thief.ready())
+    {
+        thief.exec_one_task();
+    }
+    ASSERT_EQ(m_vec.size(), task_num);
+    std::sort(m_vec.begin(), m_vec.end());
+    for (int i = 0; i < task_num; i++)
+    {
+        ASSERT_EQ(m_vec[i], i);
+    }
+    thief.deinit();
+}
+
+// test io deferred by sqe exhaustion is submitted at next poll
+TEST_F(EngineTest, DeferIOUntilSqeFree)
+{
+    int     fill_ret = 1;
+    io_info fill;
+    fill.data = reinterpret_cast<uintptr_t>(&fill_ret);
+    fill.cb   = io_cb;
+    while (auto sqe = m_engine.get_free_urs())
+    {
+        io_uring_prep_nop(sqe);
+        io_uring_sqe_set_data(sqe, &fill);
+        m_engine.add_io_submit();
+    }
+
+    int     ret = 1;
+    io_info info;
+    info.data = reinterpret_cast<uintptr_t>(&ret);
+    io_cb_retry(&info, 0);
+    ASSERT_EQ(ret, 1);
+
+    do
+    {
+        m_engine.poll_submit();
+    } while (!m_engine.empty_io());
+
+    ASSERT_EQ(fill_ret, 0);
+    ASSERT_EQ(ret, 0);
+}
+
 // TODO: Add more nopio tests for engine
 // // test add nop-io before engine poll
 // TEST_F(EngineTest, AddNopIOBeforePoll)
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cstdlib>
 #include <ctime>
+#include <memory>
 #include <tuple>
 #include <vector>
 
@@ -62,6 +63,36 @@ task<> wait_func(event<>& ev, std::atomic<int>& id, int* p)
     *p = id.fetch_add(1, std::memory_order_acq_rel) + 1;
 }
 
+class EventSelectTest : public ::testing::TestWithParam<std::tuple<int, int>>
+{
+protected:
+    void SetUp() override
+    {
+        m_first  = 0;
+        m_second = 0;
+    }
+
+    void TearDown() override {}
+
+    std::vector<std::unique_ptr<event<>>> m_evs;
+    std::atomic<int>                      m_first;
+    std::atomic<int>                      m_second;
+};
+
+task<> select_wait_func(event<>& ev1, event<>& ev2, std::atomic<int>& first, std::atomic<int>& second)
+{
+    // 两个 event 几乎同时被 set，落败节点的 cancel 可能与 set 对它的访问交错
+    auto result = co_await select(ev1.wait(), ev2.wait());
+    (result.index() == 0 ? first : second).fetch_add(1, std::memory_order_relaxed);
+}
+
+task<> select_set_func(event<>& ev1, event<>& ev2)
+{
+    ev2.set();
+    ev1.set();
+    co_return;
+}
+
 task<> set_value_func(event<int>& ev, int value)
 {
     utils::msleep(100);
@@ -115,7 +146,9 @@ INSTANTIATE_TEST_SUITE_P(
         std::make_tuple(0, 1),
         std::make_tuple(0, 100),
         std::make_tuple(0, 10000),
-        std::make_tuple(0, config::kMaxTestTaskNum)));
+        std::make_tuple(0, config::kMaxTestTaskNum),
+        // more contexts than submit buckets, contexts share buckets when waiters are resumed
+        std::make_tuple(config::kSubmitBucketNum + 4, 10000)));
 
 TEST_P(EventValueTest, SetValueAndWait)
 {
@@ -157,3 +190,31 @@ INSTANTIATE_TEST_SUITE_P(
         std::make_tuple(0, 100),
         std::make_tuple(0, 10000),
         std::make_tuple(0, config::kMaxTestTaskNum)));
+
+TEST_P(EventSelectTest, SelectCancelRacingSet)
+{
+    int thread_num, round_num;
+    std::tie(thread_num, round_num) = GetParam();
+
+    scheduler::init(thread_num);
+
+    for (int i = 0; i < round_num; i++)
+    {
+        m_evs.push_back(std::make_unique<event<>>());
+        m_evs.push_back(std::make_unique<event<>>());
+        auto& ev1 = *m_evs[m_evs.size() - 2];
+        auto& ev2 = *m_evs[m_evs.size() - 1];
+        submit_to_scheduler(select_wait_func(ev1, ev2, m_first, m_second));
+        submit_to_scheduler(select_set_func(ev1, ev2));
+    }
+
+    scheduler::loop();
+
+    // every select is resumed exactly once by one of the two events
+    ASSERT_EQ(m_first + m_second, round_num);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    EventSelectTests,
+    EventSelectTest,
+    ::testing::Values(std::make_tuple(1, 1000), std::make_tuple(3, 1000), std::make_tuple(0, 5000)));
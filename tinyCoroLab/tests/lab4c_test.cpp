@@ -32,6 +32,57 @@ protected:
     std::vector<int> m_wait_vec;
 };
 
+class WaitgroupReuseTest : public ::testing::TestWithParam<std::tuple<int, int>>
+{
+protected:
+    void SetUp() override { m_done = 0; }
+
+    void TearDown() override {}
+
+    wait_group       m_wg;
+    std::atomic<int> m_done;
+    std::vector<int> m_seen_vec;
+};
+
+task<> count_done_func(wait_group& wg, std::atomic<int>& done, int count = 1)
+{
+    done.fetch_add(1, std::memory_order_acq_rel);
+    wg.add(-count);
+    co_return;
+}
+
+// every round raises the counter from zero again, wait must suspend until all done tasks of this round finish
+task<> reuse_wait_func(wait_group& wg, std::atomic<int>& done, int done_num, std::vector<int>* seen)
+{
+    // round 1: plain add
+    wg.add(done_num);
+    for (int i = 0; i < done_num; i++)
+    {
+        submit_to_scheduler(count_done_func(wg, done));
+    }
+    co_await wg.wait();
+    seen->push_back(done.load(std::memory_order_acquire));
+
+    // round 2: reuse, the counter is raised too much and lowered by negative add
+    wg.add(done_num + 2);
+    for (int i = 0; i < done_num; i++)
+    {
+        submit_to_scheduler(count_done_func(wg, done));
+    }
+    wg.add(-2);
+    co_await wg.wait();
+    seen->push_back(done.load(std::memory_order_acquire));
+
+    // round 3: every done task drops the counter by two
+    wg.add(done_num * 2);
+    for (int i = 0; i < done_num; i++)
+    {
+        submit_to_scheduler(count_done_func(wg, done, 2));
+    }
+    co_await wg.wait();
+    seen->push_back(done.load(std::memory_order_acquire));
+}
+
 task<> done_func(wait_group& wg, std::atomic<int>& id, int* data)
 {
     *data = id.fetch_add(1, std::memory_order_acq_rel);
@@ -103,3 +154,27 @@ INSTANTIATE_TEST_SUITE_P(
         std::make_tuple(0, 100, 100),
         std::make_tuple(0, 100, 10000),
         std::make_tuple(0, 100, config::kMaxTestTaskNum)));
+
+TEST_P(WaitgroupReuseTest, ReuseAfterWait)
+{
+    int thread_num, done_num;
+    std::tie(thread_num, done_num) = GetParam();
+
+    scheduler::init(thread_num);
+
+    submit_to_scheduler(reuse_wait_func(m_wg, m_done, done_num, &m_seen_vec));
+
+    scheduler::loop();
+
+    ASSERT_EQ(m_seen_vec, std::vector<int>({done_num, done_num * 2, done_num * 3}));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    WaitgroupReuseTests,
+    WaitgroupReuseTest,
+    ::testing::Values(
+        std::make_tuple(1, 1),
+        std::make_tuple(1, 100),
+        std::make_tuple(0, 1),
+        std::make_tuple(0, 100),
+        std::make_tuple(0, 10000)));
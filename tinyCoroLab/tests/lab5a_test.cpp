@@ -91,6 +91,21 @@ protected:
     ll m_cnt;
 };
 
+class WhenallRangeScatterTest : public ::testing::TestWithParam<int>
+{
+protected:
+    void SetUp() override
+    {
+        m_cnt = 0;
+        m_sum = 0;
+    }
+
+    void TearDown() override {}
+
+    std::atomic<int> m_cnt;
+    ll               m_sum;
+};
+
 class WhenallRangeIntLockTest : public ::testing::TestWithParam<int>
 {
 protected:
@@ -286,6 +301,34 @@ task<> when_all_range_int_lock(int task_num, mutex& mtx, ll& cnt, ll& sum)
     co_return;
 }
 
+task<ll> scatter_square(ll i, std::atomic<int>& cnt)
+{
+    ++cnt;
+    co_return i* i;
+}
+
+// children run on other contexts and are destroyed as soon as when_all returns
+task<> when_all_range_scatter(int task_num, int round, std::atomic<int>& cnt, ll& sum)
+{
+    for (int r = 0; r < round; r++)
+    {
+        std::vector<task<ll>> vec;
+        for (int i = 1; i <= task_num; i++)
+        {
+            vec.emplace_back(scatter_square(i, cnt));
+        }
+
+        auto result = co_await when_all(vec, launch_policy::scatter);
+        vec.clear();
+
+        for (auto num : result)
+        {
+            sum += num;
+        }
+    }
+    co_return;
+}
+
 /*************************************************************
  *                          tests                            *
  *************************************************************/
@@ -503,3 +546,26 @@ TEST_P(WhenallRangeIntLockTest, WhenallRangeIntLock)
 }
 
 INSTANTIATE_TEST_SUITE_P(WhenallRangeIntLockTests, WhenallRangeIntLockTest, ::testing::Values(10, 100, 1000, 10000));
+
+TEST_P(WhenallRangeScatterTest, WhenallRangeScatter)
+{
+    int       task_num = GetParam();
+    const int round    = 100;
+
+    ll answer = 0;
+    for (ll i = 1; i <= task_num; i++)
+    {
+        answer += (i * i);
+    }
+
+    scheduler::init(4);
+
+    submit_to_scheduler(when_all_range_scatter(task_num, round, m_cnt, m_sum));
+
+    scheduler::loop();
+
+    ASSERT_EQ(task_num * round, m_cnt.load());
+    ASSERT_EQ(answer * round, m_sum);
+}
+
+INSTANTIATE_TEST_SUITE_P(WhenallRangeScatterTests, WhenallRangeScatterTest, ::testing::Values(1, 10, 100, 1000));
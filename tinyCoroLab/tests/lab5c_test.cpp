@@ -1,7 +1,11 @@
 #include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <optional>
 #include <queue>
+#include <span>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -86,6 +90,181 @@ protected:
     test_paras m_para;
 };
 
+class ChannelSelectTest : public ::testing::TestWithParam<std::tuple<int, int>>
+{
+protected:
+    void SetUp() override { m_resumed = 0; }
+
+    void TearDown() override {}
+
+public:
+    struct select_round
+    {
+        channel<int>     ch1;
+        channel<int>     ch2;
+        event<>          ev;
+        int              index{-1};
+        std::vector<int> vec;
+    };
+
+    auto new_round() -> select_round&
+    {
+        m_rounds.push_back(std::make_unique<select_round>());
+        return *m_rounds.back();
+    }
+
+    // values received by the select and values left in both channels
+    static auto collect(select_round& round) -> std::vector<int>
+    {
+        auto vec = round.vec;
+        for (auto ch : {&round.ch1, &round.ch2})
+        {
+            while (auto data = ch->try_recv())
+            {
+                vec.push_back(*data);
+            }
+        }
+        std::sort(vec.begin(), vec.end());
+        return vec;
+    }
+
+protected:
+    std::vector<std::unique_ptr<select_round>> m_rounds;
+    std::atomic<int>                           m_resumed;
+};
+
+task<> select_recv_event_func(ChannelSelectTest::select_round& round, std::atomic<int>& resumed)
+{
+    auto result = co_await select(round.ch1.recv(), round.ev.wait());
+    round.index = result.index();
+    if (result.index() == 0 && std::get<0>(result))
+    {
+        round.vec.push_back(*std::get<0>(result));
+    }
+    resumed.fetch_add(1, std::memory_order_relaxed);
+}
+
+task<> send_set_func(ChannelSelectTest::select_round& round, int value)
+{
+    // 交替 send 和 set 的先后顺序，让两个来源都有机会赢得 select
+    if (value & 1)
+    {
+        round.ev.set();
+        co_await round.ch1.send(value);
+    }
+    else
+    {
+        co_await round.ch1.send(value);
+        round.ev.set();
+    }
+}
+
+task<> select_two_channel_func(ChannelSelectTest::select_round& round, std::atomic<int>& resumed)
+{
+    auto result = co_await select(round.ch1.recv(), round.ch2.recv());
+    round.index = result.index();
+    auto& data  = result.index() == 0 ? std::get<0>(result) : std::get<1>(result);
+    round.vec.push_back(*data);
+
+    // 落败的 channel 中的数据没有被 select 取走，之后仍能收到
+    auto next = co_await (result.index() == 0 ? round.ch2 : round.ch1).recv();
+    round.vec.push_back(*next);
+    resumed.fetch_add(1, std::memory_order_relaxed);
+}
+
+task<> send_two_channel_func(ChannelSelectTest::select_round& round, int value)
+{
+    co_await round.ch1.send(value * 2);
+    co_await round.ch2.send(value * 2 + 1);
+}
+
+task<> close_set_func(ChannelSelectTest::select_round& round)
+{
+    round.ch1.close();
+    round.ev.set();
+    co_return;
+}
+
+class ChannelBatchTest : public ::testing::Test
+{
+protected:
+    void SetUp() override { m_resumed = 0; }
+
+    void TearDown() override {}
+
+    channel<int, 4>               m_small;
+    channel<int, 16>              m_big;
+    std::vector<std::vector<int>> m_vecs;
+    int                           m_resumed;
+};
+
+// try_send and try_recv never suspend, reuse the channels of batch test
+class ChannelTryTest : public ChannelBatchTest
+{
+};
+
+template<size_t capacity>
+task<> send_values_func(channel<int, capacity>& ch, int num, bool close)
+{
+    for (int i = 0; i < num; i++)
+    {
+        co_await ch.send(i);
+    }
+    if (close)
+    {
+        ch.close();
+    }
+}
+
+template<size_t capacity>
+task<> send_batch_func(channel<int, capacity>& ch, int num, size_t* sent, int* resumed)
+{
+    std::vector<int> values(num);
+    for (int i = 0; i < num; i++)
+    {
+        values[i] = i;
+    }
+    *sent = co_await ch.send_batch(std::span<int>(values));
+    (*resumed)++;
+}
+
+template<size_t capacity>
+task<> recv_batch_func(channel<int, capacity>& ch, size_t max_n, std::vector<int>* vec)
+{
+    *vec = co_await ch.recv_batch(max_n);
+}
+
+// receive batches until num values are received, the sender must be parked before the first batch
+template<size_t capacity>
+task<> recv_batch_until_func(channel<int, capacity>& ch, int num, int* resumed, std::vector<int>* vec)
+{
+    EXPECT_EQ(*resumed, 0);
+    while (vec->size() < static_cast<size_t>(num))
+    {
+        auto data = co_await ch.recv_batch(capacity);
+        EXPECT_LE(data.size(), capacity);
+        vec->insert(vec->end(), data.begin(), data.end());
+    }
+}
+
+template<size_t capacity>
+task<> close_func(channel<int, capacity>& ch)
+{
+    ch.close();
+    co_return;
+}
+
+task<> recv_func(channel<int, 4>& ch, std::optional<int>* data)
+{
+    *data = co_await ch.recv();
+}
+
+task<> try_send_func(channel<int, 4>& ch, int value, bool* sent)
+{
+    *sent = ch.try_send(value);
+    co_return;
+}
+
 task<> producer(ChannelTest::test_paras& para, int id, const int num_per_producer)
 {
     for (int i = 0; i < num_per_producer; i++)
@@ -309,4 +488,245 @@ TEST_F(ChannelStringTest, StringChannelProducerConsumer)
     {
         ASSERT_EQ(m_para.vec[i], str);
     }
-}
\ No newline at end of file
+}
+
+TEST_P(ChannelSelectTest, SelectRecvAndEventRacing)
+{
+    int thread_num, round_num;
+    std::tie(thread_num, round_num) = GetParam();
+
+    scheduler::init(thread_num);
+
+    for (int i = 0; i < round_num; i++)
+    {
+        auto& round = new_round();
+        submit_to_scheduler(select_recv_event_func(round, m_resumed));
+        submit_to_scheduler(send_set_func(round, i));
+    }
+
+    scheduler::loop();
+
+    // every select is resumed once, the message is either received by the select or left in channel
+    ASSERT_EQ(m_resumed, round_num);
+    for (int i = 0; i < round_num; i++)
+    {
+        auto& round = *m_rounds[i];
+        ASSERT_TRUE(round.index == 0 || round.index == 1);
+        ASSERT_EQ(round.vec.size(), round.index == 0 ? 1 : 0);
+        ASSERT_EQ(collect(round), std::vector<int>({i}));
+    }
+}
+
+TEST_P(ChannelSelectTest, SelectTwoChannelLoserRecvNext)
+{
+    int thread_num, round_num;
+    std::tie(thread_num, round_num) = GetParam();
+
+    scheduler::init(thread_num);
+
+    for (int i = 0; i < round_num; i++)
+    {
+        auto& round = new_round();
+        submit_to_scheduler(select_two_channel_func(round, m_resumed));
+        submit_to_scheduler(send_two_channel_func(round, i));
+    }
+
+    scheduler::loop();
+
+    ASSERT_EQ(m_resumed, round_num);
+    for (int i = 0; i < round_num; i++)
+    {
+        auto& round = *m_rounds[i];
+        ASSERT_EQ(round.vec.size(), 2);
+        // the first value comes from the winner channel
+        ASSERT_EQ(round.vec[0] % 2, round.index);
+        ASSERT_EQ(collect(round), std::vector<int>({i * 2, i * 2 + 1}));
+    }
+}
+
+TEST_P(ChannelSelectTest, CloseRacingSet)
+{
+    int thread_num, round_num;
+    std::tie(thread_num, round_num) = GetParam();
+
+    scheduler::init(thread_num);
+
+    for (int i = 0; i < round_num; i++)
+    {
+        auto& round = new_round();
+        submit_to_scheduler(select_recv_event_func(round, m_resumed));
+        submit_to_scheduler(close_set_func(round));
+    }
+
+    scheduler::loop();
+
+    // closed channel takes part in select with std::nullopt
+    ASSERT_EQ(m_resumed, round_num);
+    for (int i = 0; i < round_num; i++)
+    {
+        auto& round = *m_rounds[i];
+        ASSERT_TRUE(round.index == 0 || round.index == 1);
+        ASSERT_TRUE(round.vec.empty());
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ChannelSelectTests,
+    ChannelSelectTest,
+    ::testing::Values(std::make_tuple(1, 1000), std::make_tuple(3, 1000), std::make_tuple(0, 5000)));
+
+TEST_F(ChannelSelectTest, CloseParkedSelectReceiver)
+{
+    scheduler::init(1);
+
+    // select runs first on the only context and parks on both sources, close resumes it
+    auto& round = new_round();
+    submit_to_scheduler(select_recv_event_func(round, m_resumed));
+    submit_to_scheduler(close_set_func(round));
+
+    scheduler::loop();
+
+    ASSERT_EQ(m_resumed, 1);
+    ASSERT_EQ(round.index, 0);
+    ASSERT_TRUE(round.vec.empty());
+}
+
+TEST_F(ChannelBatchTest, RecvBatchPartial)
+{
+    m_vecs.resize(3);
+
+    scheduler::init(1);
+
+    submit_to_scheduler(send_values_func(m_big, 3, false));
+    submit_to_scheduler(recv_batch_func(m_big, 2, &m_vecs[0]));
+    // fewer values than max_n are buffered, recv_batch returns them without suspending
+    submit_to_scheduler(recv_batch_func(m_big, 16, &m_vecs[1]));
+    // max_n larger than capacity is clamped
+    submit_to_scheduler(send_values_func(m_big, 16, false));
+    submit_to_scheduler(recv_batch_func(m_big, 100, &m_vecs[2]));
+
+    scheduler::loop();
+
+    ASSERT_EQ(m_vecs[0], std::vector<int>({0, 1}));
+    ASSERT_EQ(m_vecs[1], std::vector<int>({2}));
+    ASSERT_EQ(m_vecs[2].size(), 16);
+    for (int i = 0; i < 16; i++)
+    {
+        ASSERT_EQ(m_vecs[2][i], i);
+    }
+}
+
+TEST_F(ChannelBatchTest, SendBatchLargerThanCapacity)
+{
+    const int num  = 10;
+    size_t    sent = 0;
+    m_vecs.resize(1);
+
+    scheduler::init(1);
+
+    // sender fills the buffer and parks, receiver frees the buffer batch by batch
+    submit_to_scheduler(send_batch_func(m_small, num, &sent, &m_resumed));
+    submit_to_scheduler(recv_batch_until_func(m_small, num, &m_resumed, &m_vecs[0]));
+
+    scheduler::loop();
+
+    ASSERT_EQ(sent, num);
+    ASSERT_EQ(m_resumed, 1);
+    ASSERT_EQ(m_vecs[0].size(), num);
+    for (int i = 0; i < num; i++)
+    {
+        ASSERT_EQ(m_vecs[0][i], i);
+    }
+}
+
+TEST_F(ChannelBatchTest, RecvBatchAfterClose)
+{
+    m_vecs.resize(3);
+
+    scheduler::init(1);
+
+    // parked receiver is woken by close with empty vector
+    submit_to_scheduler(recv_batch_func(m_big, 16, &m_vecs[0]));
+    submit_to_scheduler(send_values_func(m_small, 3, true));
+    submit_to_scheduler(close_func(m_big));
+    // values sent before close can still be received
+    submit_to_scheduler(recv_batch_func(m_small, 4, &m_vecs[1]));
+    submit_to_scheduler(recv_batch_func(m_small, 4, &m_vecs[2]));
+
+    scheduler::loop();
+
+    ASSERT_TRUE(m_vecs[0].empty());
+    ASSERT_EQ(m_vecs[1], std::vector<int>({0, 1, 2}));
+    ASSERT_TRUE(m_vecs[2].empty());
+}
+
+TEST_F(ChannelBatchTest, SendBatchWakeOneReceiver)
+{
+    const int num  = 10;
+    size_t    sent = 0;
+    m_vecs.resize(2);
+
+    scheduler::init(1);
+
+    // both receivers park, the batch is moved to the first one by a single wakeup,
+    // the second one is still parked until channel is closed
+    submit_to_scheduler(recv_batch_func(m_big, 16, &m_vecs[0]));
+    submit_to_scheduler(recv_batch_func(m_big, 16, &m_vecs[1]));
+    submit_to_scheduler(send_batch_func(m_big, num, &sent, &m_resumed));
+    submit_to_scheduler(close_func(m_big));
+
+    scheduler::loop();
+
+    ASSERT_EQ(sent, num);
+    ASSERT_EQ(m_resumed, 1);
+    ASSERT_EQ(m_vecs[0].size(), num);
+    for (int i = 0; i < num; i++)
+    {
+        ASSERT_EQ(m_vecs[0][i], i);
+    }
+    ASSERT_TRUE(m_vecs[1].empty());
+}
+
+TEST_F(ChannelTryTest, TrySendFullAndTryRecvEmpty)
+{
+    ASSERT_FALSE(m_small.try_recv().has_value());
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(m_small.try_send(i));
+    }
+    ASSERT_FALSE(m_small.try_send(4));
+
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_EQ(m_small.try_recv(), i);
+    }
+    ASSERT_FALSE(m_small.try_recv().has_value());
+}
+
+TEST_F(ChannelTryTest, TrySendAndTryRecvAfterClose)
+{
+    ASSERT_TRUE(m_small.try_send(1));
+    m_small.close();
+
+    // buffered value can still be received, nothing can be sent
+    ASSERT_FALSE(m_small.try_send(2));
+    ASSERT_EQ(m_small.try_recv(), 1);
+    ASSERT_FALSE(m_small.try_recv().has_value());
+}
+
+TEST_F(ChannelTryTest, TrySendToParkedReceiver)
+{
+    std::optional<int> data;
+    bool               sent = false;
+
+    scheduler::init(1);
+
+    submit_to_scheduler(recv_func(m_small, &data));
+    submit_to_scheduler(try_send_func(m_small, 42, &sent));
+
+    scheduler::loop();
+
+    ASSERT_TRUE(sent);
+    ASSERT_EQ(data, 42);
+    ASSERT_FALSE(m_small.try_recv().has_value());
+}
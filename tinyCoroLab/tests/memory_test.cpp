@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "config.h"
+#include "coro/allocator/memory.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro;
+using namespace coro::allocator::memory;
+namespace slab = coro::allocator::memory::detail;
+
+using slab_allocator = memory_allocator<coro::detail::memory_allocator::slab>;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+// slab tests use the default size classes, power of 2 from kSlabMinBlockSize to kSlabMaxBlockSize
+class SlabTest : public ::testing::Test
+{
+protected:
+    static auto header_of(void* ptr) -> slab::slab_header*
+    {
+        return slab::node_to_header(static_cast<slab::slab_node*>(ptr));
+    }
+
+    slab_allocator m_alloc;
+};
+
+class SlabClassTest : public SlabTest, public ::testing::WithParamInterface<size_t>
+{
+};
+
+class ProfileTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // blocks including 16 bytes header: 64 x 1500, 128 x 10, 224 x 1000, 240 x 1000, 1024 x 1
+        m_profile.sizes = {{40, 1000}, {48, 500}, {100, 10}, {200, 1000}, {210, 1000}, {1000, 1}, {5000, 7}};
+    }
+
+    auto derive(size_t max_classes, size_t max_block_size = config::kSlabMaxBlockSize) -> std::vector<size_t>
+    {
+        return derive_size_classes(m_profile, max_classes, slab::kSlabHeaderSize, max_block_size);
+    }
+
+    frame_profile m_profile;
+};
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST_P(SlabClassTest, AllocateAndReleaseInSizeClass)
+{
+    const size_t class_size = GetParam();
+    const size_t num        = 2 * config::kSlabChunkSize / class_size + 1;
+
+    // the largest and the smallest request served by this size class
+    const size_t max_size = class_size - slab::kSlabHeaderSize;
+    const size_t min_size = class_size == config::kSlabMinBlockSize ? 1 : class_size / 2 - slab::kSlabHeaderSize + 1;
+
+    std::vector<void*> ptrs;
+    for (size_t i = 0; i < num; i++)
+    {
+        auto size = (i & 1) ? max_size : min_size;
+        auto ptr  = m_alloc.allocate(size);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % __STDCPP_DEFAULT_NEW_ALIGNMENT__, 0);
+        ASSERT_EQ(header_of(ptr)->owner, slab::get_local_slab_cache());
+        ASSERT_EQ(header_of(ptr)->block_size, class_size);
+        std::memset(ptr, static_cast<int>(i), size);
+        ptrs.push_back(ptr);
+    }
+
+    // blocks never overlap, more than one chunk is carved
+    std::vector<void*> sorted(ptrs);
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t i = 1; i < sorted.size(); i++)
+    {
+        ASSERT_GE(static_cast<char*>(sorted[i]) - static_cast<char*>(sorted[i - 1]), max_size);
+    }
+
+    for (auto ptr : ptrs)
+    {
+        m_alloc.release(ptr);
+    }
+
+    // released blocks are reused before new chunk is carved
+    std::set<void*> released(ptrs.begin(), ptrs.end());
+    for (size_t i = 0; i < num; i++)
+    {
+        auto ptr = m_alloc.allocate(max_size);
+        ASSERT_EQ(released.count(ptr), 1);
+        released.erase(ptr);
+    }
+    for (auto ptr : ptrs)
+    {
+        m_alloc.release(ptr);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SlabClassTests,
+    SlabClassTest,
+    ::testing::Values(64, 128, 256, 512, 1024, 2048, 4096),
+    [](const ::testing::TestParamInfo<size_t>& info) { return std::to_string(info.param); });
+
+TEST_F(SlabTest, ReleaseOnOtherThread)
+{
+    const size_t num  = 1000;
+    const size_t size = 100;
+
+    std::vector<void*> ptrs;
+    for (size_t i = 0; i < num; i++)
+    {
+        ptrs.push_back(m_alloc.allocate(size));
+    }
+    auto owner = slab::get_local_slab_cache();
+
+    std::thread other(
+        [&]()
+        {
+            for (auto ptr : ptrs)
+            {
+                m_alloc.release(ptr);
+            }
+        });
+    other.join();
+
+    // blocks are pushed to the remote stack of owner rather than free list of other thread
+    ASSERT_NE(owner->remote_head.load(std::memory_order_acquire), nullptr);
+
+    // owner thread drains remote stack when its free list is empty, so all blocks come back
+    std::set<void*> released(ptrs.begin(), ptrs.end());
+    std::vector<void*> again;
+    while (!released.empty() && again.size() < 100 * num)
+    {
+        auto ptr = m_alloc.allocate(size);
+        ASSERT_EQ(header_of(ptr)->owner, owner);
+        released.erase(ptr);
+        again.push_back(ptr);
+    }
+    ASSERT_TRUE(released.empty());
+    ASSERT_EQ(owner->remote_head.load(std::memory_order_acquire), nullptr);
+
+    for (auto ptr : again)
+    {
+        m_alloc.release(ptr);
+    }
+}
+
+TEST_F(SlabTest, AllocateLargerThanMaxClass)
+{
+    for (size_t size : {config::kSlabMaxBlockSize - slab::kSlabHeaderSize + 1, config::kSlabMaxBlockSize, size_t(1) << 20})
+    {
+        auto ptr = m_alloc.allocate(size);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_EQ(header_of(ptr)->owner, nullptr);
+        ASSERT_EQ(header_of(ptr)->block_size, size + slab::kSlabHeaderSize);
+        std::memset(ptr, 0, size);
+        m_alloc.release(ptr);
+    }
+}
+
+TEST_F(SlabTest, AllocateFailThrowBadAlloc)
+{
+    ASSERT_THROW(m_alloc.allocate(size_t(1) << 62), std::bad_alloc);
+}
+
+TEST_F(ProfileTest, DeriveSizeClasses)
+{
+    // the biggest block is always a size class, frame bigger than max block size is ignored
+    ASSERT_EQ(derive(1), std::vector<size_t>({1024}));
+    ASSERT_EQ(derive(2), std::vector<size_t>({240, 1024}));
+
+    // 128 and 224 are served by 240, waste 10 * 112 + 1000 * 16 bytes
+    ASSERT_EQ(derive(3), std::vector<size_t>({64, 240, 1024}));
+
+    // the fourth class is 224 rather than 128, only 128 is left in a bigger class, waste 10 * 96 bytes
+    ASSERT_EQ(derive(4), std::vector<size_t>({64, 224, 240, 1024}));
+
+    // every block gets its own class if max_classes is enough
+    ASSERT_EQ(derive(5), std::vector<size_t>({64, 128, 224, 240, 1024}));
+    ASSERT_EQ(derive(32), std::vector<size_t>({64, 128, 224, 240, 1024}));
+
+    ASSERT_EQ(derive(3, 256), std::vector<size_t>({64, 224, 240}));
+}
+
+TEST_F(ProfileTest, DeriveSizeClassesEmpty)
+{
+    ASSERT_TRUE(derive(0).empty());
+    ASSERT_TRUE(derive(4, 32).empty());
+
+    frame_profile empty;
+    ASSERT_TRUE(derive_size_classes(empty, 4, slab::kSlabHeaderSize, config::kSlabMaxBlockSize).empty());
+}
+
+TEST_F(ProfileTest, SaveAndLoadProfile)
+{
+    auto path = std::string(SOURCE_DIR) + "/temp/memory/profile_test.profile";
+    ASSERT_TRUE(m_profile.save(path));
+    auto loaded = frame_profile::load(path);
+    std::remove(path.c_str());
+    ASSERT_EQ(loaded.sizes, m_profile.sizes);
+    ASSERT_EQ(derive_size_classes(loaded, 4, slab::kSlabHeaderSize, config::kSlabMaxBlockSize), derive(4));
+}
@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "coro/coro.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+class ParallelRangeTest : public ::testing::TestWithParam<int>
+{
+protected:
+    void SetUp() override { m_cnt = 0; }
+
+    void TearDown() override {}
+
+    std::atomic<int> m_cnt;
+    std::vector<int> m_vec;
+};
+
+class ParallelFuncTest : public ::testing::TestWithParam<int>
+{
+protected:
+    void SetUp() override {}
+
+    void TearDown() override {}
+
+    // subtask i returns i, the first subtask is 1
+    template<typename value_type, typename func_type>
+    static auto make_tasks(int num, func_type func) -> std::vector<task<value_type>>
+    {
+        std::vector<task<value_type>> tasks;
+        for (int i = 1; i <= num; i++)
+        {
+            tasks.push_back(func(i));
+        }
+        return tasks;
+    }
+};
+
+task<int> value_func(int i)
+{
+    co_return i;
+}
+
+task<std::string> string_func(int i)
+{
+    co_return std::to_string(i);
+}
+
+template<typename value_type, typename reduce_type, typename result_type>
+task<> collect_func(std::vector<task<value_type>>& tasks, reduce_type reduce, result_type* result)
+{
+    *result = co_await parallel::parallel_func(tasks, reduce);
+}
+
+task<> for_each_func(std::vector<int>& vec, size_t chunk, std::atomic<int>& cnt)
+{
+    co_await parallel::for_each(
+        vec,
+        chunk,
+        [&cnt](int& value)
+        {
+            value++;
+            cnt.fetch_add(1, std::memory_order_relaxed);
+        });
+}
+
+template<typename value_type, typename range_type, typename op_type>
+task<> reduce_func(range_type& range, value_type init, op_type op, value_type* result)
+{
+    *result = co_await parallel::reduce(range, std::move(init), op);
+}
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST_P(ParallelRangeTest, ForEachEmptyRange)
+{
+    scheduler::init(GetParam());
+
+    submit_to_scheduler(for_each_func(m_vec, 0, m_cnt));
+    submit_to_scheduler(for_each_func(m_vec, 4, m_cnt));
+
+    scheduler::loop();
+
+    ASSERT_EQ(m_cnt, 0);
+}
+
+TEST_P(ParallelRangeTest, ForEachChunkLargerThanRange)
+{
+    const int num = 10;
+    m_vec         = std::vector<int>(num);
+    std::iota(m_vec.begin(), m_vec.end(), 0);
+
+    scheduler::init(GetParam());
+
+    submit_to_scheduler(for_each_func(m_vec, num * 10, m_cnt));
+
+    scheduler::loop();
+
+    ASSERT_EQ(m_cnt, num);
+    for (int i = 0; i < num; i++)
+    {
+        ASSERT_EQ(m_vec[i], i + 1);
+    }
+}
+
+TEST_P(ParallelRangeTest, ForEachChunkZero)
+{
+    const int num = 10000;
+    m_vec         = std::vector<int>(num);
+    std::iota(m_vec.begin(), m_vec.end(), 0);
+
+    scheduler::init(GetParam());
+
+    // one chunk per context
+    submit_to_scheduler(for_each_func(m_vec, 0, m_cnt));
+
+    scheduler::loop();
+
+    ASSERT_EQ(m_cnt, num);
+    for (int i = 0; i < num; i++)
+    {
+        ASSERT_EQ(m_vec[i], i + 1);
+    }
+}
+
+TEST_P(ParallelRangeTest, ForEachUnevenChunk)
+{
+    const int num = 10000;
+    m_vec         = std::vector<int>(num);
+    std::iota(m_vec.begin(), m_vec.end(), 0);
+
+    scheduler::init(GetParam());
+
+    // the last chunk is shorter than the others
+    submit_to_scheduler(for_each_func(m_vec, 7, m_cnt));
+
+    scheduler::loop();
+
+    ASSERT_EQ(m_cnt, num);
+    for (int i = 0; i < num; i++)
+    {
+        ASSERT_EQ(m_vec[i], i + 1);
+    }
+}
+
+TEST_P(ParallelRangeTest, ReduceEmptyRange)
+{
+    long long result = 0;
+
+    scheduler::init(GetParam());
+
+    submit_to_scheduler(reduce_func(m_vec, 42LL, std::plus<>{}, &result));
+
+    scheduler::loop();
+
+    ASSERT_EQ(result, 42);
+}
+
+TEST_P(ParallelRangeTest, ReduceInitOnce)
+{
+    const int num = 10000;
+    m_vec         = std::vector<int>(num);
+    std::iota(m_vec.begin(), m_vec.end(), 1);
+    std::vector<int> single{5};
+    long long        sum     = 0;
+    long long        product = 0;
+    long long        one     = 0;
+
+    scheduler::init(GetParam());
+
+    submit_to_scheduler(reduce_func(m_vec, 1000LL, std::plus<>{}, &sum));
+    // init applied twice would make the product 20
+    submit_to_scheduler(reduce_func(single, 2LL, std::multiplies<>{}, &product));
+    submit_to_scheduler(reduce_func(single, 1000LL, std::plus<>{}, &one));
+
+    scheduler::loop();
+
+    ASSERT_EQ(sum, 1000LL + 1LL * num * (num + 1) / 2);
+    ASSERT_EQ(product, 10);
+    ASSERT_EQ(one, 1005);
+}
+
+TEST_P(ParallelRangeTest, ReduceKeepRangeOrder)
+{
+    const int                num = 1000;
+    std::vector<std::string> strs;
+    std::string              expect = "init";
+    for (int i = 0; i < num; i++)
+    {
+        strs.push_back(std::to_string(i) + ",");
+        expect += strs.back();
+    }
+    std::string result;
+
+    scheduler::init(GetParam());
+
+    // string concatenation is associative but not commutative
+    submit_to_scheduler(reduce_func(
+        strs, std::string("init"), [](std::string a, const std::string& b) { return std::move(a) + b; }, &result));
+
+    scheduler::loop();
+
+    ASSERT_EQ(result, expect);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParallelRangeTests, ParallelRangeTest, ::testing::Values(1, 3, 0));
+
+TEST_P(ParallelFuncTest, VectorReduceRvalue)
+{
+    const int        num   = 1000;
+    auto             tasks = make_tasks<int>(num, value_func);
+    std::vector<int> result;
+
+    scheduler::init(GetParam());
+
+    // results are moved into reduce in subtask order
+    submit_to_scheduler(collect_func(tasks, [](std::vector<int>&& vec) { return std::move(vec); }, &result));
+
+    scheduler::loop();
+
+    ASSERT_EQ(result.size(), num);
+    for (int i = 0; i < num; i++)
+    {
+        ASSERT_EQ(result[i], i + 1);
+    }
+}
+
+TEST_P(ParallelFuncTest, VectorReduceLvalue)
+{
+    const int num    = 1000;
+    auto      tasks  = make_tasks<int>(num, value_func);
+    long long result = 0;
+
+    scheduler::init(GetParam());
+
+    submit_to_scheduler(collect_func(
+        tasks,
+        [](std::vector<int>& vec) { return std::accumulate(vec.begin(), vec.end(), 0LL); },
+        &result));
+
+    scheduler::loop();
+
+    ASSERT_EQ(result, 1LL * num * (num + 1) / 2);
+}
+
+TEST_P(ParallelFuncTest, BinaryOpCommutative)
+{
+    const int num    = 1000;
+    auto      tasks  = make_tasks<int>(num, value_func);
+    int       result = 0;
+
+    scheduler::init(GetParam());
+
+    submit_to_scheduler(collect_func(tasks, std::plus<>{}, &result));
+
+    scheduler::loop();
+
+    ASSERT_EQ(result, num * (num + 1) / 2);
+}
+
+TEST_P(ParallelFuncTest, BinaryOpNonCommutative)
+{
+    auto        int_tasks    = make_tasks<int>(9, value_func);
+    auto        string_tasks = make_tasks<std::string>(100, string_func);
+    int         digits       = 0;
+    std::string str;
+    std::string expect;
+    for (int i = 1; i <= 100; i++)
+    {
+        expect += std::to_string(i);
+    }
+
+    scheduler::init(GetParam());
+
+    // appending decimal digits is associative but not commutative, results must be combined in order
+    submit_to_scheduler(collect_func(
+        int_tasks,
+        [](int a, int b)
+        {
+            int base = 10;
+            while (base <= b)
+            {
+                base *= 10;
+            }
+            return a * base + b;
+        },
+        &digits));
+    submit_to_scheduler(collect_func(
+        string_tasks, [](std::string a, std::string b) { return std::move(a) + b; }, &str));
+
+    scheduler::loop();
+
+    ASSERT_EQ(digits, 123456789);
+    ASSERT_EQ(str, expect);
+}
+
+TEST_P(ParallelFuncTest, BinaryOpNoSubtask)
+{
+    std::vector<task<int>> tasks;
+    int                    result = -1;
+
+    scheduler::init(GetParam());
+
+    submit_to_scheduler(collect_func(tasks, std::plus<>{}, &result));
+
+    scheduler::loop();
+
+    ASSERT_EQ(result, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParallelFuncTests, ParallelFuncTest, ::testing::Values(1, 3, 0));
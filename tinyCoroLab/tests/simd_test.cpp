@@ -0,0 +1,194 @@
+#include <string>
+#include <vector>
+
+#include "coro/detail/simd.hpp"
+#include "coro/utils.hpp"
+#include "gtest/gtest.h"
+
+using namespace coro;
+using coro::detail::simd_level;
+namespace simd = coro::detail::simd;
+
+/*************************************************************
+ *                       pre-definition                      *
+ *************************************************************/
+
+int main(int argc, char** argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+// every test runs once for each simd level, levels not supported by cpu are skipped
+class SimdTest : public ::testing::TestWithParam<simd_level>
+{
+protected:
+    void SetUp() override
+    {
+        m_origin = simd::level();
+        if (simd::set_level(GetParam()) != GetParam())
+        {
+            GTEST_SKIP() << "simd level isn't supported by cpu or disabled by config";
+        }
+    }
+
+    void TearDown() override { simd::set_level(m_origin); }
+
+    // all 256 byte values in a shuffled order, so every simd block mixes letters and others
+    static auto all_bytes(size_t len) -> std::string
+    {
+        std::string s(len, '\0');
+        for (size_t i = 0; i < len; i++)
+        {
+            s[i] = static_cast<char>((i * 97 + 13) % 256);
+        }
+        return s;
+    }
+
+    simd_level m_origin;
+};
+
+/*************************************************************
+ *                          tests                            *
+ *************************************************************/
+
+TEST_P(SimdTest, FindHeadEndAtEveryOffset)
+{
+    // covers "\r\n\r\n" inside one block and straddling 16 and 32 bytes block edges
+    const size_t len = 100;
+    for (size_t start = 0; start < 4; start++)
+    {
+        for (size_t pos = start; pos + 4 <= len; pos++)
+        {
+            std::string buf(len, 'a');
+            buf.replace(pos, 4, "\r\n\r\n");
+            auto first = buf.data() + start;
+            auto last  = buf.data() + len;
+            ASSERT_EQ(simd::find_head_end(first, last), buf.data() + pos + 4) << "start " << start << " pos " << pos;
+        }
+    }
+}
+
+TEST_P(SimdTest, FindHeadEndNotFound)
+{
+    const size_t len = 100;
+    for (size_t pos = 0; pos + 3 <= len; pos++)
+    {
+        // single line ends and a partial head end never match
+        std::string buf(len, 'a');
+        buf.replace(pos, 3, "\r\n\r");
+        if (pos >= 2)
+        {
+            buf.replace(pos - 2, 2, "\n\n");
+        }
+        ASSERT_EQ(simd::find_head_end(buf.data(), buf.data() + len), nullptr) << "pos " << pos;
+    }
+
+    // "\r\n\r\n" just after last is out of range
+    for (size_t len = 0; len < 70; len++)
+    {
+        std::string buf = std::string(len, 'a') + "\r\n\r\n";
+        ASSERT_EQ(simd::find_head_end(buf.data(), buf.data() + len), nullptr) << "len " << len;
+        ASSERT_EQ(simd::find_head_end(buf.data(), buf.data() + len + 3), nullptr) << "len " << len;
+        ASSERT_EQ(simd::find_head_end(buf.data(), buf.data() + len + 4), buf.data() + len + 4) << "len " << len;
+    }
+}
+
+TEST_P(SimdTest, FindAnyAtTailBoundary)
+{
+    for (size_t len = 0; len < 70; len++)
+    {
+        // target just after last is out of range
+        std::string buf = std::string(len, 'x') + ":\r";
+        auto        first = buf.data();
+        auto        last  = buf.data() + len;
+        ASSERT_EQ(simd::find_any(first, last, ':', '\r'), last) << "len " << len;
+        ASSERT_EQ(simd::find_any(first, last + 1, ':', '\r'), last) << "len " << len;
+        ASSERT_EQ(simd::find_any(first, last + 2, '\r', '\n'), last + 1) << "len " << len;
+
+        for (size_t pos = 0; pos < len; pos++)
+        {
+            std::string s(len, 'x');
+            s[pos] = (pos & 1) ? ':' : '\r';
+            if (pos + 1 < len)
+            {
+                s[len - 1] = ':';
+            }
+            ASSERT_EQ(simd::find_any(s.data(), s.data() + len, ':', '\r'), s.data() + pos)
+                << "len " << len << " pos " << pos;
+        }
+    }
+}
+
+TEST_P(SimdTest, ToLowerAllBytes)
+{
+    for (size_t len : {0, 1, 15, 16, 17, 31, 32, 33, 255, 256, 300})
+    {
+        auto        src = all_bytes(len);
+        std::string dst(len, '\0');
+        simd::to_lower(src.data(), len, dst.data());
+        for (size_t i = 0; i < len; i++)
+        {
+            ASSERT_EQ(static_cast<unsigned char>(dst[i]), utils::to_lower(src[i])) << "len " << len << " i " << i;
+        }
+
+        // convert in place
+        simd::to_lower(src.data(), len, src.data());
+        ASSERT_EQ(src, dst);
+    }
+}
+
+TEST_P(SimdTest, IequalAllBytePairs)
+{
+    // every pair of byte values, placed at a different offset to hit both simd blocks and the tail
+    const size_t len = 48;
+    for (int a = 0; a < 256; a++)
+    {
+        for (int b = 0; b < 256; b++)
+        {
+            std::string s1(len, 'K');
+            std::string s2(len, 'k');
+            auto        pos = static_cast<size_t>(a + b) % len;
+            s1[pos]         = static_cast<char>(a);
+            s2[pos]         = static_cast<char>(b);
+            auto expect     = utils::to_lower(a) == utils::to_lower(b);
+            ASSERT_EQ(simd::iequal(s1.data(), s2.data(), len), expect) << "a " << a << " b " << b;
+            ASSERT_EQ(simd::iequal(s1.data(), s2.data(), pos + 1), expect) << "a " << a << " b " << b;
+            ASSERT_TRUE(simd::iequal(s1.data(), s2.data(), pos)) << "a " << a << " b " << b;
+        }
+    }
+}
+
+TEST_P(SimdTest, HashSameAsHashCore)
+{
+    utils::hash hasher;
+    for (size_t len = 0; len < 200; len++)
+    {
+        auto s = all_bytes(len);
+        ASSERT_EQ(hasher(s), hasher.hash_core(s.data(), s.size(), 0)) << "len " << len;
+
+        std::string upper(s);
+        for (auto& c : upper)
+        {
+            c = (c >= 'a' && c <= 'z') ? c - 'a' + 'A' : c;
+        }
+        ASSERT_EQ(hasher(upper), hasher(s)) << "len " << len;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SimdTests,
+    SimdTest,
+    ::testing::Values(simd_level::scalar, simd_level::sse42, simd_level::avx2),
+    [](const ::testing::TestParamInfo<simd_level>& info) -> std::string
+    {
+        switch (info.param)
+        {
+            case simd_level::scalar:
+                return "scalar";
+            case simd_level::sse42:
+                return "sse42";
+            default:
+                return "avx2";
+        }
+    });